@@ -0,0 +1,19 @@
+#include <Arduino.h>
+#define setup lab_setup
+#define loop lab_loop
+#include "../Lab 01 - Starting simple/Lab 01-01 Start with the basics.cpp"
+#undef setup
+#undef loop
+#include "Benchmark.h"
+
+int main(void) {
+    simulated_arduino_begin();
+    Benchmark benchmark("01-01");
+
+    // Every pin is written out by hand in setup(), so starting up is all it can do. Its start up writes the first few characters as well
+    benchmark.run("init", lab_setup);
+    benchmark.unsupported("full_screen");
+    benchmark.unsupported("single_cell");
+    benchmark.unsupported("numbers");
+    return 0;
+}
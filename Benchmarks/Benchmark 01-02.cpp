@@ -0,0 +1,47 @@
+#include <Arduino.h>
+#define setup lab_setup
+#define loop lab_loop
+#include "../Lab 01 - Starting simple/Lab 01-02 Dont repeat yourself!.cpp"
+#undef setup
+#undef loop
+#include "Benchmark.h"
+
+// The sketch only has send_command() and pulse_enable(), so the workloads are built from those the same way its setup() uses them
+void write_text(const char *text) {
+    digitalWrite(REGISTER_SELECT_PIN, HIGH);
+    while (*text) {
+        send_command(*text++);
+        pulse_enable();
+    }
+}
+
+void set_address(byte address) {
+    digitalWrite(REGISTER_SELECT_PIN, LOW);
+    send_command(0x80 | address);
+    pulse_enable();
+}
+
+int main(void) {
+    simulated_arduino_begin();
+    Benchmark benchmark("01-02");
+
+    // The display is started in setup(), along with writing "Hello"
+    benchmark.run("init", lab_setup);
+    benchmark.run("full_screen", [] {
+        set_address(0x00);
+        write_text(workload::TOP_LINE);
+        set_address(0x40);
+        write_text(workload::BOTTOM_LINE);
+    }, workload::TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.run("single_cell", [] {
+        set_address(workload::SINGLE_CELL_COLUMN);
+        const char text[2] = {workload::SINGLE_CELL_CHARACTER, '\0'};
+        write_text(text);
+    }, workload::SINGLE_CELL_TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.run("numbers", [] {
+        for (int number : workload::NUMBERS) {
+            write_text((String(number) + " ").c_str());
+        }
+    });
+    return 0;
+}
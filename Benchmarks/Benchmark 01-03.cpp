@@ -0,0 +1,36 @@
+#include <Arduino.h>
+#define setup lab_setup
+#define loop lab_loop
+#include "../Lab 01 - Starting simple/Lab 01-03 Everything neatly in its own function.cpp"
+#undef setup
+#undef loop
+#include "Benchmark.h"
+
+// There is no function to move the cursor, so that is built from send_command() and pulse_enable()
+void set_address(byte address) {
+    digitalWrite(REGISTER_SELECT_PIN, LOW);
+    send_command(0x80 | address);
+    pulse_enable();
+}
+
+int main(void) {
+    simulated_arduino_begin();
+    Benchmark benchmark("01-03");
+
+    benchmark.run("init", initialize_lcd_device);
+    benchmark.run("full_screen", [] {
+        print_text(workload::TOP_LINE);
+        set_address(0x40);
+        print_text(workload::BOTTOM_LINE);
+    }, workload::TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.run("single_cell", [] {
+        set_address(workload::SINGLE_CELL_COLUMN);
+        print_text(String(workload::SINGLE_CELL_CHARACTER));
+    }, workload::SINGLE_CELL_TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.run("numbers", [] {
+        for (int number : workload::NUMBERS) {
+            print_text(String(number) + " ");
+        }
+    });
+    return 0;
+}
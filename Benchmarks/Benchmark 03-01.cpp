@@ -0,0 +1,27 @@
+#include <mbed.h>
+#define main lab_main
+#include "../Lab 03 - Cross platform development/Lab 03-01 Porting to Mbed.cpp"
+#undef main
+#include "Benchmark.h"
+
+BusOut *data_bus;
+LCD_Display *my_lcd_screen;
+
+int main(void) {
+    Benchmark benchmark("03-01");
+
+    benchmark.run("init", [] {
+        data_bus = new BusOut(D9, D8, D7, D6, D5, D4, D3, D2);
+        my_lcd_screen = new LCD_Display(D12, D11, D10, data_bus);
+    });
+    benchmark.run("full_screen", [] {
+        my_lcd_screen->printf("%s%s", workload::padded_top_line().c_str(), workload::BOTTOM_LINE);
+    }, workload::TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.unsupported("single_cell");          // printf() can only carry on from the last character
+    benchmark.run("numbers", [] {
+        for (int number : workload::NUMBERS) {
+            my_lcd_screen->printf("%d ", number);
+        }
+    });
+    return 0;
+}
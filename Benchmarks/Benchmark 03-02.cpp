@@ -0,0 +1,26 @@
+#include <mbed.h>
+#define main lab_main
+#include "../Lab 03 - Cross platform development/Lab 03-02 Pins known at compile time.cpp"
+#undef main
+#include "Benchmark.h"
+
+typedef LCD_Display<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_LCD_Display;
+My_LCD_Display *my_lcd_screen;
+
+int main(void) {
+    Benchmark benchmark("03-02");
+
+    benchmark.run("init", [] {
+        my_lcd_screen = new My_LCD_Display;
+    });
+    benchmark.run("full_screen", [] {
+        my_lcd_screen->printf("%s%s", workload::padded_top_line().c_str(), workload::BOTTOM_LINE);
+    }, workload::TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.unsupported("single_cell");          // printf() can only carry on from the last character
+    benchmark.run("numbers", [] {
+        for (int number : workload::NUMBERS) {
+            my_lcd_screen->printf("%d ", number);
+        }
+    });
+    return 0;
+}
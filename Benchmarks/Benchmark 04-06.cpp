@@ -0,0 +1,30 @@
+#include <Arduino.h>
+#define setup lab_setup
+#define loop lab_loop
+#include "../Lab 04 - Going faster/Lab 04-06 Pins known at compile time.cpp"
+#undef setup
+#undef loop
+#include "Benchmark.h"
+
+typedef LCD_Display<D12, NOT_CONNECTED, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_LCD_Display;     // timed mode, the same as the lab
+My_LCD_Display *my_lcd_screen;
+
+int main(void) {
+    simulated_arduino_begin();
+    Benchmark benchmark("04-06");
+
+    benchmark.run("init", [] {
+        my_lcd_screen = new My_LCD_Display;
+    });
+    benchmark.run("full_screen", [] {
+        my_lcd_screen->print_text(workload::padded_top_line().c_str());
+        my_lcd_screen->print_text(workload::BOTTOM_LINE);
+    }, workload::TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.unsupported("single_cell");          // print_text() is all there is, and it can only carry on from the last character
+    benchmark.run("numbers", [] {
+        for (int number : workload::NUMBERS) {
+            my_lcd_screen->print_text(String(number) + " ");
+        }
+    });
+    return 0;
+}
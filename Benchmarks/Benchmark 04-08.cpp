@@ -0,0 +1,36 @@
+#include <Arduino.h>
+#define setup lab_setup
+#define loop lab_loop
+#include "../Lab 04 - Going faster/Lab 04-08 Printing without the heap.cpp"
+#undef setup
+#undef loop
+#include "Benchmark.h"
+
+// The lab already has a my_lcd_screen pointer for loop() to use, which the workloads share
+
+int main(void) {
+    simulated_arduino_begin();
+    Benchmark benchmark("04-08");
+
+    benchmark.run("init", [] {
+        constexpr byte DATA_BUS[8] = {D9, D8, D7, D6, D5, D4, D3, D2};
+        my_lcd_screen = new LCD_Display(D12, NOT_CONNECTED, D10, DATA_BUS);     // timed mode, the same as the lab
+    });
+    benchmark.run("full_screen", [] {
+        my_lcd_screen->set_cursor(0, 0);
+        my_lcd_screen->print_text(workload::TOP_LINE);
+        my_lcd_screen->set_cursor(0, 1);
+        my_lcd_screen->print_text(workload::BOTTOM_LINE);
+    }, workload::TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.run("single_cell", [] {
+        my_lcd_screen->set_cursor(workload::SINGLE_CELL_COLUMN, 0);
+        my_lcd_screen->print_char(workload::SINGLE_CELL_CHARACTER);
+    }, workload::SINGLE_CELL_TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.run("numbers", [] {
+        for (int number : workload::NUMBERS) {
+            my_lcd_screen->print_number(number);
+            my_lcd_screen->print_char(' ');
+        }
+    });
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include <Arduino.h>
+#define setup lab_setup
+#define loop lab_loop
+#include "../Lab 06 - One driver for every board/Lab 06-01 Arduino backend.cpp"
+#undef setup
+#undef loop
+#include "Benchmark.h"
+
+My_LCD_Display *my_lcd_screen;
+
+int main(void) {
+    simulated_arduino_begin();
+    Benchmark benchmark("06-01");
+
+    benchmark.run("init", [] {
+        my_lcd_screen = new My_LCD_Display;
+    });
+    benchmark.run("full_screen", [] {
+        my_lcd_screen->set_cursor(0, 0);
+        my_lcd_screen->print_text(workload::TOP_LINE);
+        my_lcd_screen->set_cursor(0, 1);
+        my_lcd_screen->print_text(workload::BOTTOM_LINE);
+    }, workload::TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.run("single_cell", [] {
+        my_lcd_screen->set_cursor(workload::SINGLE_CELL_COLUMN, 0);
+        const char text[2] = {workload::SINGLE_CELL_CHARACTER, '\0'};
+        my_lcd_screen->print_text(text);
+    }, workload::SINGLE_CELL_TOP_LINE, workload::BOTTOM_LINE);
+    benchmark.run("numbers", [] {
+        // The shared driver has no number formatting yet, so this is the same snprintf() an application would use
+        for (int number : workload::NUMBERS) {
+            char text[8];
+            snprintf(text, sizeof(text), "%d ", number);
+            my_lcd_screen->print_text(text);
+        }
+    });
+    return 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "Simulated_Board.h"
+
+// Runs the same workloads against each generation of the driver, one executable per lab, and prints one JSON object per line:
+//      {"driver": "01-02", "workload": "full_screen", "gpio_calls": 608, "pin_transitions": 410, "simulated_us": 36864.0,
+//       "mcu_cycles": 589824, "host_ns": 51200, "violations": 0, "screen_correct": true}
+// gpio_calls          accesses to the GPIO hardware, see Simulated_Board::gpio_access()
+// pin_transitions     times any pin changed level, the display only cares about these
+// simulated_us        how long the workload took on the board, waiting included
+// mcu_cycles          the same time in the board's CPU cycles
+// host_ns             how long the simulation took on this machine, which is mostly the cost of the shims
+// violations          timing and busy violations the simulated HD44780 saw during the workload
+// screen_correct      whether the display showed what the workload meant it to, or null if the workload has no fixed result
+// A driver that can't do a workload with the API it has gets "supported": false instead of the numbers.
+// Nothing here fails the run, the earliest labs get the screen wrong and break every timing rule, and that is the point of the
+// later ones. Gate on the results instead, eg that no workload got slower and nothing that was correct stopped being correct.
+// The labs that print to Serial print to stdout too, so only lines starting with {"driver" are results
+namespace workload {
+    constexpr const char *TOP_LINE = "Benchmark line 1";
+    constexpr const char *BOTTOM_LINE = "0123456789ABCDEF";
+    constexpr const char *SINGLE_CELL_TOP_LINE = "Bench*ark line 1";     // the full screen, with column 5 of the top row changed
+    constexpr uint8_t SINGLE_CELL_COLUMN = 5;
+    constexpr char SINGLE_CELL_CHARACTER = '*';
+    constexpr int NUMBERS[] = {0, 7, -42, 1234, 65535};
+
+    // Lines written by drivers with no way to set the cursor. 40 columns of DDRAM per line in two line mode, so the top line
+    // is padded out to 40 characters and the bottom line lands at the start of the second row
+    inline std::string padded_top_line(void) {
+        std::string line(TOP_LINE);
+        line.resize(40, ' ');
+        return line;
+    }
+}
+
+class Benchmark {
+    public:
+        Benchmark(const char *driver) : _driver(driver) {}
+
+        // Runs one workload and prints what it cost. Pass the lines the display should end up showing, or nullptr to skip the check
+        template <typename Workload>
+        void run(const char *name, Workload work, const char *top = nullptr, const char *bottom = nullptr) {
+            // Every workload starts with the display idle, the way it would be after the application had been off doing something else
+            simulated_board.advance_ns(_SETTLE_NS);
+
+            uint64_t gpio_calls = simulated_board.gpio_calls();
+            uint64_t pin_transitions = simulated_board.pin_transitions();
+            uint64_t started_ps = simulated_board.now_ps();
+            uint64_t cycles = simulated_board.cycles();
+            uint32_t violations = simulated_board.violations();
+            auto host_started = std::chrono::steady_clock::now();
+
+            work();
+
+            uint64_t host_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - host_started).count();
+            violations = simulated_board.violations() - violations;
+
+            const char *screen_correct = "null";
+            if (top) {
+                bool correct = simulated_board.display(0).visible_line(0) == top && simulated_board.display(0).visible_line(1) == bottom;
+                screen_correct = correct ? "true" : "false";
+            }
+
+            std::printf("{\"driver\": \"%s\", \"workload\": \"%s\", \"gpio_calls\": %llu, \"pin_transitions\": %llu, \"simulated_us\": %.1f, "
+                "\"mcu_cycles\": %llu, \"host_ns\": %llu, \"violations\": %u, \"screen_correct\": %s}\n",
+                _driver, name, (unsigned long long)(simulated_board.gpio_calls() - gpio_calls),
+                (unsigned long long)(simulated_board.pin_transitions() - pin_transitions), (simulated_board.now_ps() - started_ps) / 1e6,
+                (unsigned long long)(simulated_board.cycles() - cycles), (unsigned long long)host_ns, violations, screen_correct);
+            std::fflush(stdout);
+        }
+
+        void unsupported(const char *name) {
+            std::printf("{\"driver\": \"%s\", \"workload\": \"%s\", \"supported\": false}\n", _driver, name);
+        }
+
+    private:
+        constexpr static uint64_t _SETTLE_NS = 2000000;    // longer than a clear takes
+
+        const char *_driver;
+};
@@ -0,0 +1,412 @@
+#pragma once
+
+// Host stand in for the Arduino core. Just enough of the API for the labs to compile on Linux,
+// with every call driving the simulated board instead of real hardware.
+//
+// GPIO calls cost roughly what they do on an ATmega328P running the stock Arduino core at 16MHz,
+// and delay() and friends move the simulated clock on rather than sleeping, so a sketch runs in a
+// fraction of the time it would take on the board.
+
+#include <math.h>            // the real Arduino.h includes math.h, so sketches can use isnan(), sqrt() and friends without including it
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "Simulated_Board.h"
+
+#define HOST_SIMULATOR 1
+#define F_CPU 16000000UL
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT           0x0
+#define OUTPUT          0x1
+#define INPUT_PULLUP    0x2
+
+constexpr uint8_t D0 = 0, D1 = 1, D2 = 2, D3 = 3, D4 = 4, D5 = 5, D6 = 6, D7 = 7;
+constexpr uint8_t D8 = 8, D9 = 9, D10 = 10, D11 = 11, D12 = 12, D13 = 13;
+constexpr uint8_t A0 = 14, A1 = 15, A2 = 16, A3 = 17, A4 = 18, A5 = 19;    // numbered on from D13, the same as an Uno
+
+// Which simulated board pin (D0-D15 = 0-15, A0-A5 = 16-21) an Arduino pin number is wired to
+inline uint8_t simulated_pin(uint8_t pin) {
+    return pin < 14 ? pin : pin + 2;
+}
+
+// Approximate cost in CPU cycles of the Arduino core functions on an ATmega328P
+namespace arduino_costs {
+    constexpr uint32_t PIN_MODE = 60;
+    constexpr uint32_t DIGITAL_WRITE = 56;     // pin to port lookup, timer check and a read-modify-write, about 3.5us
+    constexpr uint32_t DIGITAL_READ = 52;
+    constexpr uint32_t MICROS = 40;
+    constexpr uint32_t LOOP = 20;              // one trip around the main loop, including serialEventRun()
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+    simulated_board.gpio_access(arduino_costs::PIN_MODE);
+    simulated_board.pin_mode(simulated_pin(pin), mode == OUTPUT ? Simulated_Board::mode_output
+        : mode == INPUT_PULLUP ? Simulated_Board::mode_input_pullup : Simulated_Board::mode_input);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+    simulated_board.gpio_access(arduino_costs::DIGITAL_WRITE);
+    simulated_board.write_pin(simulated_pin(pin), value != LOW);
+}
+
+inline int digitalRead(uint8_t pin) {
+    simulated_board.gpio_access(arduino_costs::DIGITAL_READ);
+    return simulated_board.read_pin(simulated_pin(pin)) ? HIGH : LOW;
+}
+
+inline void delay(unsigned long ms) {
+    simulated_board.advance_ns(ms * 1000000ULL);
+}
+
+inline void delayMicroseconds(unsigned int us) {
+    simulated_board.advance_ns(us * 1000ULL);
+}
+
+// micros() only counts in steps of 4us at 16MHz, just like the real one
+inline unsigned long micros(void) {
+    simulated_board.advance_cycles(arduino_costs::MICROS);
+    return (unsigned long)(simulated_board.now_ns() / 1000) & ~3UL;
+}
+
+inline unsigned long millis(void) {
+    return (unsigned long)(simulated_board.now_ns() / 1000000);
+}
+
+// Interrupts, so drivers can protect their read-modify-write port accesses. Nothing interrupts the sketch
+// on the host unless a shim timer is running, but we keep track so those can honour it
+inline bool simulated_interrupts_enabled = true;
+
+inline void noInterrupts(void) {
+    simulated_board.advance_cycles(1);         // cli
+    simulated_interrupts_enabled = false;
+}
+
+inline void interrupts(void) {
+    simulated_interrupts_enabled = true;
+    simulated_board.reschedule();               // anything that came due while interrupts were off runs now
+    simulated_board.advance_cycles(1);         // sei
+}
+
+// Called while the core is waiting on something, a good place for a busy loop to give way
+inline void yield(void) {
+    simulated_board.advance_cycles(4);
+}
+
+#define _BV(bit) (1 << (bit))
+
+// Timer1 in CTC mode, which is enough to run a compare match interrupt. Writing any of its registers
+// makes the board look at the timer again, the same way the hardware picks up a new setting
+template <typename T>
+class Simulated_Timer_Register {
+    public:
+        operator T() const { return _value; }
+        Simulated_Timer_Register &operator=(T value) { _value = value; simulated_board.reschedule(); return *this; }
+        Simulated_Timer_Register &operator|=(T value) { return *this = _value | value; }
+        Simulated_Timer_Register &operator&=(T value) { return *this = _value & value; }
+
+    private:
+        T _value = 0;
+};
+
+inline Simulated_Timer_Register<uint8_t> TCCR1A, TCCR1B, TIMSK1;
+inline Simulated_Timer_Register<uint16_t> OCR1A, TCNT1;
+
+#define CS10    0
+#define CS11    1
+#define CS12    2
+#define WGM12   3
+#define OCIE1A  1
+
+#define ISR(vector) extern "C" void vector(void)
+extern "C" void TIMER1_COMPA_vect(void) __attribute__((weak));
+
+namespace arduino_costs {
+    constexpr uint32_t INTERRUPT = 30;         // getting into and back out of an interrupt handler, saving registers on the way
+}
+
+inline uint64_t simulated_timer1_next_ps = Simulated_Board::NEVER;
+
+inline uint64_t run_simulated_timers(void) {
+    static const uint16_t PRESCALERS[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+    uint16_t prescaler = PRESCALERS[TCCR1B & 0x07];
+    bool running = prescaler && (TCCR1B & _BV(WGM12)) && (TIMSK1 & _BV(OCIE1A)) && TIMER1_COMPA_vect;
+    if (!running) {
+        simulated_timer1_next_ps = Simulated_Board::NEVER;
+        return Simulated_Board::NEVER;
+    }
+
+    // The counter runs from when the timer was first started, so turning the interrupt on and off doesn't move the ticks
+    static uint64_t started_ps = simulated_board.now_ps();
+    uint64_t period_ps = uint64_t(OCR1A + 1) * prescaler * (1000000000000ULL / F_CPU);
+    uint64_t now_ps = simulated_board.now_ps();
+    if (simulated_timer1_next_ps == Simulated_Board::NEVER) {
+        simulated_timer1_next_ps = started_ps + ((now_ps - started_ps) / period_ps + 1) * period_ps;
+    }
+
+    if (now_ps >= simulated_timer1_next_ps) {
+        if (!simulated_interrupts_enabled) {
+            return Simulated_Board::NEVER;      // stays pending until interrupts() is called
+        }
+        simulated_interrupts_enabled = false;   // the AVR clears the global interrupt flag on the way into a handler
+        simulated_board.advance_cycles(arduino_costs::INTERRUPT);
+        TIMER1_COMPA_vect();
+        simulated_interrupts_enabled = true;
+        simulated_timer1_next_ps += period_ps;
+        if (simulated_timer1_next_ps <= simulated_board.now_ps()) {
+            simulated_timer1_next_ps = started_ps + ((simulated_board.now_ps() - started_ps) / period_ps + 1) * period_ps;
+        }
+    }
+    return simulated_timer1_next_ps;
+}
+
+// avr-gcc turns this into an exact number of cycles of busy waiting, here it just moves the clock on
+inline void __builtin_avr_delay_cycles(unsigned long cycles) {
+    simulated_board.advance_cycles(cycles);
+}
+
+// Port registers, laid out like an ATmega328P: D0-D7 on PORTD, D8-D13 on PORTB and A0-A5 on PORTC.
+// Each register is a small object that forwards reads and writes to the simulated board, so a
+// single write moves all of the port's pins at the same instant, just like the hardware.
+#define NOT_A_PIN 0
+#define NOT_A_PORT 0
+#define PB 2
+#define PC 3
+#define PD 4
+
+class Simulated_Port_Register {
+    public:
+        enum Kind: uint8_t {
+            port_output,    // PORTx: output levels, or pull ups on input pins
+            port_input,     // PINx: what the pins read
+            port_mode,      // DDRx: 1 = output, 0 = input
+        };
+
+        constexpr Simulated_Port_Register(uint8_t first_pin, uint8_t pin_count, Kind kind)
+            : _first_pin(first_pin), _pin_count(pin_count), _kind(kind) {}
+
+        operator uint8_t() const {
+            simulated_board.gpio_access(2);            // ld through a pointer
+            return read();
+        }
+
+        Simulated_Port_Register &operator=(uint8_t value) {
+            simulated_board.gpio_access(2);            // st through a pointer
+            write(value);
+            return *this;
+        }
+
+        Simulated_Port_Register &operator|=(uint8_t value) { return *this = uint8_t(*this) | value; }
+        Simulated_Port_Register &operator&=(uint8_t value) { return *this = uint8_t(*this) & value; }
+        Simulated_Port_Register &operator^=(uint8_t value) { return *this = uint8_t(*this) ^ value; }
+
+    private:
+        const uint8_t _first_pin, _pin_count;
+        const Kind _kind;
+
+        uint8_t read(void) const {
+            uint8_t value = 0;
+            for (uint8_t bit = 0; bit < _pin_count; bit++) {
+                uint8_t pin = _first_pin + bit;
+                Simulated_Board::Pin_Mode mode = simulated_board.mode(pin);
+                bool set = _kind == port_input ? simulated_board.read_pin(pin)
+                         : _kind == port_mode ? mode == Simulated_Board::mode_output
+                         : mode == Simulated_Board::mode_output ? simulated_board.level(pin) : mode == Simulated_Board::mode_input_pullup;
+                value |= set << bit;
+            }
+            return value;
+        }
+
+        void write(uint8_t value) {
+            uint32_t pin_mask = 0, levels = 0;
+            for (uint8_t bit = 0; bit < _pin_count; bit++) {
+                uint8_t pin = _first_pin + bit;
+                bool set = value & (1 << bit);
+                bool output = simulated_board.mode(pin) == Simulated_Board::mode_output;
+
+                if (_kind == port_mode && set != output) {
+                    simulated_board.pin_mode(pin, set ? Simulated_Board::mode_output : Simulated_Board::mode_input);
+                }
+                else if (_kind == port_output && output) {
+                    pin_mask |= 1UL << pin;
+                    levels |= uint32_t(set) << pin;
+                }
+                else if (_kind == port_output) {
+                    simulated_board.pin_mode(pin, set ? Simulated_Board::mode_input_pullup : Simulated_Board::mode_input);
+                }
+            }
+            simulated_board.write_pins(pin_mask, levels);    // every output pin on the port changes in the same instant
+        }
+};
+
+inline Simulated_Port_Register simulated_ports[3][3] = {
+    {{8, 6, Simulated_Port_Register::port_output}, {8, 6, Simulated_Port_Register::port_input}, {8, 6, Simulated_Port_Register::port_mode}},
+    {{16, 6, Simulated_Port_Register::port_output}, {16, 6, Simulated_Port_Register::port_input}, {16, 6, Simulated_Port_Register::port_mode}},
+    {{0, 8, Simulated_Port_Register::port_output}, {0, 8, Simulated_Port_Register::port_input}, {0, 8, Simulated_Port_Register::port_mode}},
+};
+
+#define PORTB (simulated_ports[0][0])
+#define PINB  (simulated_ports[0][1])
+#define DDRB  (simulated_ports[0][2])
+#define PORTC (simulated_ports[1][0])
+#define PINC  (simulated_ports[1][1])
+#define DDRC  (simulated_ports[1][2])
+#define PORTD (simulated_ports[2][0])
+#define PIND  (simulated_ports[2][1])
+#define DDRD  (simulated_ports[2][2])
+
+inline uint8_t digitalPinToPort(uint8_t pin) {
+    return pin < 8 ? PD : pin < 14 ? PB : pin < 20 ? PC : NOT_A_PORT;
+}
+
+inline uint8_t digitalPinToBitMask(uint8_t pin) {
+    return 1 << (pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14);
+}
+
+// NOT_A_PORT has no registers, so it gets nullptr, the same as the AVR core's tables give it
+inline Simulated_Port_Register *portOutputRegister(uint8_t port) { return port == NOT_A_PORT ? nullptr : &simulated_ports[port - PB][0]; }
+inline Simulated_Port_Register *portInputRegister(uint8_t port) { return port == NOT_A_PORT ? nullptr : &simulated_ports[port - PB][1]; }
+inline Simulated_Port_Register *portModeRegister(uint8_t port) { return port == NOT_A_PORT ? nullptr : &simulated_ports[port - PB][2]; }
+
+// Flash strings. The host has no separate program memory, so these are ordinary pointers
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(string_literal) (string_literal)
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+inline uint8_t pgm_read_byte(const void *address) {
+    return *(const uint8_t *)address;
+}
+
+inline size_t strlen_P(const char *text) {
+    return std::strlen(text);
+}
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// How many times the heap has been asked for memory. Arduino's String allocates a buffer of exactly the right size whenever
+// it is given text and doesn't have room for it, so we count the same way here. Only the simulator can count this: a stock board
+// build has no hook into malloc(), and __brkval only moves the first time the heap grows, not when a String frees and allocates
+// again. So labs read it inside #ifdef HOST_SIMULATOR
+inline unsigned long simulated_heap_allocations = 0;
+
+// A small String class with the parts of the Arduino one that the labs use
+class String {
+    public:
+        String(const char *text = "") : _text(text) { reserve(); }
+        String(const __FlashStringHelper *text) : _text(reinterpret_cast<const char *>(text)) { reserve(); }
+        String(const String &other) : _text(other._text) { reserve(); }
+        String(String &&other) : _text(std::move(other._text)), _capacity(other._capacity) { other._capacity = 0; }
+        String(char c) : _text(1, c) { reserve(); }
+        String(int value) : _text(std::to_string(value)) { reserve(); }
+        String(unsigned int value) : _text(std::to_string(value)) { reserve(); }
+        String(long value) : _text(std::to_string(value)) { reserve(); }
+        String(unsigned long value) : _text(std::to_string(value)) { reserve(); }
+
+        String &operator=(const String &rhs) { _text = rhs._text; reserve(); return *this; }
+        String &operator=(String &&rhs) { std::swap(_text, rhs._text); std::swap(_capacity, rhs._capacity); return *this; }
+
+        unsigned int length(void) const { return _text.length(); }
+        const char *c_str(void) const { return _text.c_str(); }
+        char operator[](unsigned int index) const { return index < _text.length() ? _text[index] : 0; }
+        char &operator[](unsigned int index) { return _text[index]; }
+
+        String &operator+=(const String &rhs) { _text += rhs._text; reserve(); return *this; }
+        friend String operator+(String lhs, const String &rhs) { return std::move(lhs += rhs); }
+        bool operator==(const String &rhs) const { return _text == rhs._text; }
+
+    private:
+        std::string _text;
+        unsigned int _capacity = 0;
+
+        void reserve(void) {
+            if (_text.length() > _capacity) {
+                simulated_heap_allocations++;
+                _capacity = _text.length();
+            }
+        }
+};
+
+// Serial goes straight to stdout
+class Simulated_Serial {
+    public:
+        void begin(unsigned long baud) { (void)baud; }
+
+        size_t print(const char *text) { return std::fputs(text, stdout), std::strlen(text); }
+        size_t print(const String &text) { return print(text.c_str()); }
+        size_t print(const __FlashStringHelper *text) { return print(reinterpret_cast<const char *>(text)); }
+        size_t print(char c) { return std::fputc(c, stdout), 1; }
+        size_t print(int value, int base = DEC) { return print((long)value, base); }
+        size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+        size_t print(long value, int base = DEC) {
+            if (base == DEC && value < 0) return print('-') + print(0UL - (unsigned long)value, base);
+            return print((unsigned long)value, base);   // like the real one, other bases print negative numbers as their two's complement
+        }
+        size_t print(unsigned long value, int base = DEC) {
+            char digits[8 * sizeof(unsigned long) + 1];
+            char *first = digits + sizeof(digits) - 1;
+            *first = '\0';
+            if (base < 2) base = DEC;
+            do {
+                int digit = value % base;
+                *--first = digit < 10 ? '0' + digit : 'A' + digit - 10;
+                value /= base;
+            } while (value > 0);
+            return print(first);
+        }
+        size_t print(double value, int digits = 2) { return std::printf("%.*f", digits, value); }
+
+        template <typename T>
+        size_t println(T value) { size_t written = print(value); return written + print("\r\n"); }
+        template <typename T>
+        size_t println(T value, int format) { size_t written = print(value, format); return written + print("\r\n"); }
+        size_t println(void) { return print("\r\n"); }
+};
+
+inline Simulated_Serial Serial;
+
+void setup(void);
+void loop(void);
+
+// Sets the clock and timers up the way the Arduino core does before it calls setup()
+inline void simulated_arduino_begin(void) {
+    simulated_board.set_cpu_frequency(F_CPU);
+    simulated_board.on_advance(run_simulated_timers);
+}
+
+// The Arduino core calls setup() once and then loop() forever. On the host we run loop() for a
+// fixed amount of simulated time (HOST_SIM_RUN_MS, 100ms by default) and then report what the displays saw.
+// Define HOST_SIM_NO_MAIN to bring your own main(), eg to drive a sketch's functions from a benchmark
+#ifndef HOST_SIM_NO_MAIN
+int main(void) {
+    simulated_arduino_begin();
+
+    const char *run_ms = std::getenv("HOST_SIM_RUN_MS");
+    uint64_t run_for_ns = (run_ms ? std::strtoull(run_ms, nullptr, 10) : 100) * 1000000ULL;
+
+    setup();
+
+    uint64_t stop_at_ns = simulated_board.now_ns() + run_for_ns;
+    while (simulated_board.now_ns() < stop_at_ns) {
+        loop();
+        simulated_board.advance_cycles(arduino_costs::LOOP);
+    }
+
+    simulated_board.print_report();
+    return simulated_board.exit_code();
+}
+#endif
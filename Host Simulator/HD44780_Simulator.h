@@ -0,0 +1,415 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// A software model of the Hitachi HD44780 controller, wired up in 8 bit mode.
+// It watches the RS, RW and E lines plus the data bus the same way the real chip does:
+// instructions and data are latched on the falling edge of E, and the bus is driven by the
+// controller while RW is HIGH and E is HIGH. Everything is timed against the simulated clock,
+// so we can see when a driver talks to the display before it has finished its last instruction.
+class HD44780_Simulator {
+    public:
+        // Execution times from the datasheet (Table 6, fosc = 270kHz)
+        static constexpr uint64_t CLEAR_EXEC_NS = 1520000;         // clear display and return home take 1.52ms
+        static constexpr uint64_t INSTRUCTION_EXEC_NS = 37000;     // everything else takes 37us
+        static constexpr uint64_t DATA_EXEC_NS = 37000 + 4000;     // writing data takes 37us, plus tADD of 4us to update the address counter
+        static constexpr uint64_t POWER_ON_RESET_NS = 15000000;    // wait more than 15ms after VCC rises to 4.5V
+
+        // Initialising by instruction (Figure 23), for when the supply rose too slowly for the internal reset circuit to work.
+        // Three function sets with 8 bit mode selected, the busy flag can't be checked until the third one has gone in
+        static constexpr uint8_t INIT_FUNCTION_SETS = 3;
+        static constexpr uint64_t INIT_FIRST_WAIT_NS = 4100000;    // wait more than 4.1ms after the first one
+        static constexpr uint64_t INIT_SECOND_WAIT_NS = 100000;    // and more than 100us after the second
+
+        // Bus timing minimums (Figure 25 and 26, VCC = 4.5 to 5.5V)
+        static constexpr uint64_t T_AS_NS = 40;         // RS and RW setup time before E rises
+        static constexpr uint64_t PW_EH_NS = 230;       // E pulse width, high level
+        static constexpr uint64_t T_CYC_E_NS = 500;     // enable cycle time, rising edge to rising edge
+        static constexpr uint64_t T_DSW_NS = 80;        // data setup time before E falls
+        static constexpr uint64_t T_H_NS = 10;          // data hold time after E falls
+        static constexpr uint64_t T_DDR_NS = 160;       // data delay time, E rising to valid data on a read
+
+        static constexpr uint8_t DDRAM_LINE_LENGTH = 40;
+        static constexpr uint8_t SECOND_LINE_ADDRESS = 0x40;
+
+        HD44780_Simulator(uint8_t columns = 16, uint8_t rows = 2, uint64_t ready_at_ns = 0, bool needs_init_by_instruction = false)
+            : _columns(columns), _rows(rows), _busy_until_ns(ready_at_ns),
+              _init_function_sets(needs_init_by_instruction ? 0 : INIT_FUNCTION_SETS)
+        {
+            for (uint8_t &cell : _ddram) cell = ' ';
+            for (uint8_t &row : _cgram) row = 0;
+        }
+
+        // Called by the simulated board whenever any of the pins wired to this controller change
+        void sample(bool rs, bool rw, bool e, uint8_t data, uint64_t now_ns) {
+            if (rs != _rs || rw != _rw) {
+                if (_e) {
+                    violation(now_ns, "RS/RW changed while E was high");
+                }
+                _control_changed_ns = now_ns;
+            }
+            if (data != _data) {
+                if (!_e && _e_fell_ns != NEVER && now_ns - _e_fell_ns < T_H_NS) {
+                    violation(now_ns, "data hold time (tH) not met after E fell");
+                }
+                _data_changed_ns = now_ns;
+            }
+
+            _rs = rs;
+            _rw = rw;
+            _data = data;
+
+            if (e && !_e) {
+                enable_rising(now_ns);
+            }
+            else if (!e && _e) {
+                enable_falling(now_ns);
+            }
+            _e = e;
+        }
+
+        // True while the controller is driving the data bus, ie a read cycle is in progress
+        bool driving_bus(void) const {
+            return _e && _rw;
+        }
+
+        uint8_t bus_output(uint64_t now_ns) {
+            if (now_ns - _e_rose_ns < T_DDR_NS) {
+                violation(now_ns, "bus sampled before read data was valid (tDDR)");
+            }
+            return _read_latch;
+        }
+
+        bool busy(uint64_t now_ns) const {
+            return now_ns < _busy_until_ns;
+        }
+
+        // Screen and memory contents
+        uint8_t columns(void) const { return _columns; }
+        uint8_t rows(void) const { return _rows; }
+        uint8_t ddram(uint8_t address) const { return _ddram[address & 0x7F]; }
+        uint8_t cgram(uint8_t address) const { return _cgram[address & 0x3F]; }
+        uint8_t address_counter(void) const { return _address_counter; }
+        bool display_on(void) const { return _display_on; }
+        bool two_lines(void) const { return _two_lines; }
+
+        // The DDRAM character currently showing at a given row and column, taking the display shift into account
+        uint8_t visible_character(uint8_t row, uint8_t column) const {
+            if (!_two_lines) {
+                uint8_t line_length = DDRAM_LINE_LENGTH * 2;
+                return _ddram[(row * _columns + column + _display_shift) % line_length];
+            }
+            return _ddram[row * SECOND_LINE_ADDRESS + (column + _display_shift) % DDRAM_LINE_LENGTH];
+        }
+
+        std::string visible_line(uint8_t row) const {
+            std::string line;
+            for (uint8_t column = 0; column < _columns; column++) {
+                uint8_t character = visible_character(row, column);
+                if (character < 8) {
+                    line += char('0' + character);          // custom CGRAM characters show up as their slot number
+                }
+                else if (character >= 0x20 && character < 0x7E) {
+                    line += char(character);
+                }
+                else {
+                    line += '?';                            // anything else lives in the character ROM, no ASCII equivalent
+                }
+            }
+            return line;
+        }
+
+        // Statistics
+        uint32_t instruction_writes(void) const { return _instruction_writes; }
+        uint32_t data_writes(void) const { return _data_writes; }
+        uint32_t reads(void) const { return _reads; }
+        uint32_t busy_violations(void) const { return _busy_violations; }
+        uint32_t timing_violations(void) const { return _timing_violations; }
+        uint32_t data_intervals(void) const { return _data_intervals; }
+        uint64_t data_interval_ns(void) const { return _data_interval_ns; }
+        uint64_t data_idle_ns(void) const { return _data_idle_ns; }
+        uint64_t first_write_ns(void) const { return _first_write_ns; }
+        uint64_t first_data_write_ns(void) const { return _first_data_write_ns; }
+        uint64_t last_write_ns(void) const { return _last_write_ns; }
+
+        void print_report(std::FILE *out, const char *name) const {
+            if (_instruction_writes + _data_writes + _reads == 0) {
+                return;
+            }
+
+            std::fprintf(out, "HD44780 on %s: %u instructions, %u data writes, %u reads, %u busy violations, %u timing violations\n",
+                name, _instruction_writes, _data_writes, _reads, _busy_violations, _timing_violations);
+
+            std::fprintf(out, "  +%s+%s\n", std::string(_columns, '-').c_str(), _display_on ? "" : " (display off)");
+            for (uint8_t row = 0; row < _rows; row++) {
+                std::fprintf(out, "  |%s|\n", visible_line(row).c_str());
+            }
+            std::fprintf(out, "  +%s+\n", std::string(_columns, '-').c_str());
+
+            if (_data_intervals > 0) {
+                double per_character_us = _data_interval_ns / 1000.0 / _data_intervals;
+                double idle_percent = _data_interval_ns ? 100.0 * _data_idle_ns / _data_interval_ns : 0.0;
+                std::fprintf(out, "  bus time per character: %.1f us (controller needs %.1f us, %.1f%% spent idle), %.0f characters per second\n",
+                    per_character_us, DATA_EXEC_NS / 1000.0, idle_percent, per_character_us > 0 ? 1e6 / per_character_us : 0.0);
+            }
+            if (_last_write_ns != NEVER) {
+                std::fprintf(out, "  first write at %.3f ms, ", _first_write_ns / 1e6);
+                if (_first_data_write_ns != NEVER) {
+                    std::fprintf(out, "first character at %.3f ms, ", _first_data_write_ns / 1e6);
+                }
+                std::fprintf(out, "last write at %.3f ms\n", _last_write_ns / 1e6);
+            }
+            for (const std::string &message : _violation_log) {
+                std::fprintf(out, "  %s\n", message.c_str());
+            }
+            if (_busy_violations + _timing_violations > _violation_log.size()) {
+                std::fprintf(out, "  ... %zu more\n", _busy_violations + _timing_violations - _violation_log.size());
+            }
+        }
+
+    private:
+        static constexpr uint64_t NEVER = ~uint64_t(0);
+        static constexpr size_t MAX_LOGGED_VIOLATIONS = 8;
+        static constexpr uint64_t IDLE_GAP_NS = 5000000;
+
+        const uint8_t _columns, _rows;
+
+        // Pin state as last seen
+        bool _rs = false, _rw = false, _e = false;
+        uint8_t _data = 0;
+        uint64_t _control_changed_ns = 0, _data_changed_ns = 0;
+        uint64_t _e_rose_ns = NEVER, _e_fell_ns = NEVER;
+        uint8_t _read_latch = 0;
+
+        // Controller state, as left by the internal reset circuit
+        uint8_t _ddram[0x80];
+        uint8_t _cgram[0x40];
+        uint8_t _address_counter = 0;
+        bool _address_cgram = false;
+        bool _increment = true, _entry_shift = false;
+        bool _display_on = false, _cursor_on = false, _cursor_blink = false;
+        bool _eight_bit = true, _two_lines = false, _large_font = false;
+        uint8_t _display_shift = 0;
+        uint64_t _busy_until_ns;
+        uint8_t _init_function_sets;        // how many of the initialisation function sets have gone in, INIT_FUNCTION_SETS once we are done
+
+        // Statistics
+        uint32_t _instruction_writes = 0, _data_writes = 0, _reads = 0;
+        uint32_t _busy_violations = 0, _timing_violations = 0;
+        uint64_t _first_write_ns = NEVER, _first_data_write_ns = NEVER, _last_write_ns = NEVER, _last_exec_ns = 0;
+        uint64_t _data_interval_ns = 0, _data_idle_ns = 0;
+        uint32_t _data_intervals = 0;
+        bool _last_write_was_data = false;
+        std::vector<std::string> _violation_log;
+
+        void log(uint64_t now_ns, const char *message) {
+            if (_violation_log.size() < MAX_LOGGED_VIOLATIONS) {
+                char line[128];
+                std::snprintf(line, sizeof(line), "%10.3f us: %s", now_ns / 1000.0, message);
+                _violation_log.push_back(line);
+            }
+        }
+
+        void violation(uint64_t now_ns, const char *message) {
+            _timing_violations++;
+            log(now_ns, message);
+        }
+
+        void enable_rising(uint64_t now_ns) {
+            if (now_ns - _control_changed_ns < T_AS_NS) {
+                violation(now_ns, "address setup time (tAS) not met before E rose");
+            }
+            if (_e_rose_ns != NEVER && now_ns - _e_rose_ns < T_CYC_E_NS) {
+                violation(now_ns, "enable cycle time (tcycE) not met");
+            }
+            _e_rose_ns = now_ns;
+
+            if (_rw) {
+                // Read cycle, the controller starts driving the bus
+                if (!_rs) {
+                    _read_latch = (busy(now_ns) ? 0x80 : 0x00) | (_address_counter & 0x7F);
+                }
+                else {
+                    if (busy(now_ns)) {
+                        _busy_violations++;
+                        log(now_ns, "data read while the controller was busy");
+                    }
+                    _read_latch = _address_cgram ? _cgram[_address_counter & 0x3F] : _ddram[_address_counter & 0x7F];
+                }
+            }
+        }
+
+        void enable_falling(uint64_t now_ns) {
+            _e_fell_ns = now_ns;
+            if (now_ns - _e_rose_ns < PW_EH_NS) {
+                violation(now_ns, "enable pulse width (PWEH) too short");
+            }
+
+            if (_rw) {
+                _reads++;
+                if (_rs) {
+                    // Reading data moves the address counter along, just like a write does
+                    move_address_counter(_increment);
+                    _busy_until_ns = now_ns + DATA_EXEC_NS;
+                }
+                return;
+            }
+
+            if (now_ns - _data_changed_ns < T_DSW_NS) {
+                violation(now_ns, "data setup time (tDSW) not met before E fell");
+            }
+
+            if (busy(now_ns)) {
+                // The controller ignores anything sent while it is still executing
+                _busy_violations++;
+                char message[96];
+                std::snprintf(message, sizeof(message), "%s 0x%02X sent while busy for another %.3f us, ignored",
+                    _rs ? "data" : "instruction", _data, (_busy_until_ns - now_ns) / 1000.0);
+                log(now_ns, message);
+                return;
+            }
+
+            if (_init_function_sets < INIT_FUNCTION_SETS && !initialise_by_instruction(now_ns)) {
+                return;
+            }
+
+            uint64_t exec_ns = _rs ? write_data(_data) : execute_instruction(_data);
+            if (_init_function_sets < INIT_FUNCTION_SETS) {
+                // Part way through the handshake the controller takes longer than the datasheet's usual 37us
+                exec_ns = ++_init_function_sets == 1 ? INIT_FIRST_WAIT_NS : _init_function_sets == 2 ? INIT_SECOND_WAIT_NS : exec_ns;
+            }
+
+            if (_first_data_write_ns == NEVER && _rs) {
+                _first_data_write_ns = now_ns;
+            }
+            if (_first_write_ns == NEVER) {
+                _first_write_ns = now_ns;
+            }
+            else if (_rs && _last_write_was_data && now_ns - _last_write_ns < IDLE_GAP_NS) {
+                // Only character to character gaps count towards the bus time per character, longer gaps mean the application had nothing to send
+                uint64_t interval_ns = now_ns - _last_write_ns;
+                _data_intervals++;
+                _data_interval_ns += interval_ns;
+                _data_idle_ns += interval_ns > _last_exec_ns ? interval_ns - _last_exec_ns : 0;
+            }
+            _last_write_ns = now_ns;
+            _last_exec_ns = exec_ns;
+            _last_write_was_data = _rs;
+            _busy_until_ns = now_ns + exec_ns;
+        }
+
+        // Until the handshake is done, only a function set with 8 bit mode selected gets through
+        bool initialise_by_instruction(uint64_t now_ns) {
+            if (!_rs && (_data & 0xF0) == 0x30) {
+                return true;
+            }
+            char message[96];
+            std::snprintf(message, sizeof(message), "%s 0x%02X sent before initialising by instruction was finished, ignored",
+                _rs ? "data" : "instruction", _data);
+            violation(now_ns, message);
+            return false;
+        }
+
+        uint64_t execute_instruction(uint8_t instruction) {
+            _instruction_writes++;
+
+            if (instruction & 0x80) {           // set DDRAM address
+                _address_counter = instruction & 0x7F;
+                _address_cgram = false;
+            }
+            else if (instruction & 0x40) {      // set CGRAM address
+                _address_counter = instruction & 0x3F;
+                _address_cgram = true;
+            }
+            else if (instruction & 0x20) {      // function set
+                _eight_bit = instruction & 0x10;
+                _two_lines = instruction & 0x08;
+                _large_font = instruction & 0x04;
+                if (!_eight_bit) {
+                    violation(_e_fell_ns, "4 bit mode selected, only 8 bit mode is modelled");
+                }
+            }
+            else if (instruction & 0x10) {      // cursor or display shift
+                bool shift_display = instruction & 0x08;
+                bool right = instruction & 0x04;
+                if (shift_display) {
+                    shift(right);
+                }
+                else {
+                    move_address_counter(right);
+                }
+            }
+            else if (instruction & 0x08) {      // display on/off control
+                _display_on = instruction & 0x04;
+                _cursor_on = instruction & 0x02;
+                _cursor_blink = instruction & 0x01;
+            }
+            else if (instruction & 0x04) {      // entry mode set
+                _increment = instruction & 0x02;
+                _entry_shift = instruction & 0x01;
+            }
+            else if (instruction & 0x02) {      // return home
+                _address_counter = 0;
+                _address_cgram = false;
+                _display_shift = 0;
+                return CLEAR_EXEC_NS;
+            }
+            else if (instruction & 0x01) {      // clear display
+                for (uint8_t &cell : _ddram) cell = ' ';
+                _address_counter = 0;
+                _address_cgram = false;
+                _display_shift = 0;
+                _increment = true;
+                return CLEAR_EXEC_NS;
+            }
+            return INSTRUCTION_EXEC_NS;
+        }
+
+        uint64_t write_data(uint8_t value) {
+            _data_writes++;
+
+            if (_address_cgram) {
+                _cgram[_address_counter & 0x3F] = value;
+                _address_counter = (_address_counter + (_increment ? 1 : -1)) & 0x3F;
+                return DATA_EXEC_NS;
+            }
+
+            _ddram[_address_counter & 0x7F] = value;
+            move_address_counter(_increment);
+            if (_entry_shift) {
+                shift(!_increment);
+            }
+            return DATA_EXEC_NS;
+        }
+
+        // DDRAM addresses run 0x00-0x27 and 0x40-0x67 in two line mode, or 0x00-0x4F in one line mode
+        void move_address_counter(bool increment) {
+            if (_address_cgram) {
+                _address_counter = (_address_counter + (increment ? 1 : -1)) & 0x3F;
+                return;
+            }
+            if (!_two_lines) {
+                _address_counter = increment ? (_address_counter + 1) % 0x50 : (_address_counter + 0x4F) % 0x50;
+                return;
+            }
+            if (increment) {
+                if (_address_counter == DDRAM_LINE_LENGTH - 1) _address_counter = SECOND_LINE_ADDRESS;
+                else if (_address_counter == SECOND_LINE_ADDRESS + DDRAM_LINE_LENGTH - 1) _address_counter = 0;
+                else _address_counter++;
+            }
+            else {
+                if (_address_counter == 0) _address_counter = SECOND_LINE_ADDRESS + DDRAM_LINE_LENGTH - 1;
+                else if (_address_counter == SECOND_LINE_ADDRESS) _address_counter = DDRAM_LINE_LENGTH - 1;
+                else _address_counter--;
+            }
+        }
+
+        // Shifting the display left moves the window to the right along DDRAM, and vice versa
+        void shift(bool right) {
+            uint8_t line_length = _two_lines ? DDRAM_LINE_LENGTH : DDRAM_LINE_LENGTH * 2;
+            _display_shift = right ? (_display_shift + line_length - 1) % line_length : (_display_shift + 1) % line_length;
+        }
+};
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "HD44780_Simulator.h"
+
+// The simulated board that sits behind our Arduino.h and mbed.h shims. It keeps a simulated clock,
+// the level and mode of every pin, and a set of HD44780 controllers wired up the same way as in the labs:
+//
+//      RS = D12, RW = D11, DB0-DB7 = D9, D8, D7, D6, D5, D4, D3, D2
+//      E  = D10 for the first panel, D13, A0 and A1 for up to three more panels sharing the same bus
+//
+// Every GPIO call made through the shims costs a number of CPU cycles, so the clock moves forward
+// the same way it would on the real MCU and the controllers can check our timing.
+//
+// A few environment variables change how the board behaves:
+//      HD44780_SIM_STRICT=1        exit with a non zero code if any display saw a busy or timing violation
+//      HD44780_SIM_COLD_BOOT=1     power the displays up together with the MCU, so they are busy for the first 15ms, and as if
+//                                  the supply rose too slowly for their internal reset, so they must be initialised by instruction
+//      HD44780_SIM_RW_GROUNDED=1   tie RW to ground on every panel, the way a lot of boards are wired
+class Simulated_Board {
+    public:
+        static constexpr uint8_t PIN_COUNT = 22;            // D0-D15 are pins 0-15, A0-A5 are pins 16-21
+        static constexpr uint8_t REGISTER_SELECT_PIN = 12;
+        static constexpr uint8_t READ_WRITE_PIN = 11;
+        static constexpr uint8_t DATA_BUS_PINS[8] = {9, 8, 7, 6, 5, 4, 3, 2};
+        static constexpr uint8_t DISPLAY_COUNT = 4;
+        static constexpr uint8_t ENABLE_PINS[DISPLAY_COUNT] = {10, 13, 16, 17};
+        static constexpr const char *ENABLE_PIN_NAMES[DISPLAY_COUNT] = {"E=D10", "E=D13", "E=A0", "E=A1"};
+
+        enum Pin_Mode: uint8_t {
+            mode_input,
+            mode_output,
+            mode_input_pullup,
+        };
+
+        Simulated_Board()
+            : _strict(option("HD44780_SIM_STRICT")), _rw_grounded(option("HD44780_SIM_RW_GROUNDED"))
+        {
+            bool cold_boot = option("HD44780_SIM_COLD_BOOT");
+            uint64_t ready_at_ns = cold_boot ? HD44780_Simulator::POWER_ON_RESET_NS : 0;
+            for (uint8_t i = 0; i < DISPLAY_COUNT; i++) {
+                _displays.emplace_back(16, 2, ready_at_ns, cold_boot);
+            }
+        }
+
+        // Clock, kept in picoseconds so that one cycle of any common MCU clock is a whole number
+        void set_cpu_frequency(uint32_t hz) {
+            _picoseconds_per_cycle = 1000000000000ULL / hz;
+        }
+
+        uint32_t cpu_frequency(void) const {
+            return uint32_t(1000000000000ULL / _picoseconds_per_cycle);
+        }
+
+        uint64_t now_ns(void) const {
+            return _clock_ps / 1000;
+        }
+
+        uint64_t cycles(void) const {
+            return _clock_ps / _picoseconds_per_cycle;
+        }
+
+        void advance_cycles(uint64_t cycles) {
+            advance_ps(cycles * _picoseconds_per_cycle);
+        }
+
+        void advance_ns(uint64_t ns) {
+            advance_ps(ns * 1000);
+        }
+
+        // What the shims call for every access to the GPIO hardware: a digitalWrite(), each gpio_write() inside a BusOut, a load
+        // or store to a port register. It costs the same as advance_cycles(), and is counted for the benchmarks
+        void gpio_access(uint64_t cycles) {
+            _gpio_calls++;
+            advance_cycles(cycles);
+        }
+
+        // Lets the shims run their timers and interrupts as time moves on. The hook runs whatever is due
+        // and returns the time in picoseconds when it next needs to run, or NEVER if nothing is scheduled
+        static constexpr uint64_t NEVER = ~uint64_t(0);
+
+        void on_advance(std::function<uint64_t(void)> hook) {
+            std::lock_guard<std::recursive_mutex> guard(_lock);
+            _advance_hook = hook;
+            _next_event_ps = 0;
+        }
+
+        // Asks for the hook to run again straight away, eg because a timer was reconfigured or interrupts were turned back on
+        void reschedule(void) {
+            _next_event_ps = 0;
+        }
+
+        uint64_t now_ps(void) const {
+            return _clock_ps;
+        }
+
+        // Pins
+        void pin_mode(uint8_t pin, Pin_Mode mode) {
+            std::lock_guard<std::recursive_mutex> guard(_lock);
+            if (pin >= PIN_COUNT) return;
+            _modes[pin] = mode;
+            update_displays();
+        }
+
+        void write_pin(uint8_t pin, bool level) {
+            if (pin >= PIN_COUNT) return;
+            write_pins(1UL << pin, level ? 1UL << pin : 0);
+        }
+
+        // Writes any number of pins in the same instant, the way a single port register write does
+        void write_pins(uint32_t pin_mask, uint32_t levels) {
+            std::lock_guard<std::recursive_mutex> guard(_lock);
+            uint32_t changed = (_levels ^ levels) & pin_mask;
+            _levels = (_levels & ~pin_mask) | (levels & pin_mask);
+            if (changed) {
+                _pin_changes++;
+                _pin_transitions += __builtin_popcount(changed);
+                update_displays();
+            }
+        }
+
+        bool read_pin(uint8_t pin) {
+            std::lock_guard<std::recursive_mutex> guard(_lock);
+            if (pin >= PIN_COUNT) return false;
+            if (_modes[pin] == mode_output) {
+                return _levels & (1UL << pin);
+            }
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                if (DATA_BUS_PINS[bit] != pin) continue;
+                for (HD44780_Simulator &display : _displays) {
+                    if (display.driving_bus()) {
+                        return (display.bus_output(now_ns()) >> bit) & 1;
+                    }
+                }
+            }
+            return _modes[pin] == mode_input_pullup;       // nobody is driving it, the pull up wins or it floats low
+        }
+
+        Pin_Mode mode(uint8_t pin) const {
+            return pin < PIN_COUNT ? _modes[pin] : mode_input;
+        }
+
+        // The level we are driving a pin to, which is only what it reads if the pin is an output
+        bool level(uint8_t pin) const {
+            return _levels & (1UL << pin);
+        }
+
+        uint32_t read_pins(void) {
+            uint32_t levels = 0;
+            for (uint8_t pin = 0; pin < PIN_COUNT; pin++) {
+                if (read_pin(pin)) levels |= 1UL << pin;
+            }
+            return levels;
+        }
+
+        HD44780_Simulator &display(uint8_t index = 0) {
+            return _displays[index];
+        }
+
+        // Counts pin changes so the Mbed shim can tell when the application has gone quiet
+        uint64_t pin_changes(void) const {
+            return _pin_changes;
+        }
+
+        // For the benchmarks: how many GPIO accesses the shims have made, and how many times any pin has changed level
+        uint64_t gpio_calls(void) const {
+            return _gpio_calls;
+        }
+
+        uint64_t pin_transitions(void) const {
+            return _pin_transitions;
+        }
+
+        uint32_t violations(void) const {
+            uint32_t total = _bus_contentions;
+            for (const HD44780_Simulator &display : _displays) {
+                total += display.busy_violations() + display.timing_violations();
+            }
+            return total;
+        }
+
+        // For a lab's own checks, eg that printing never touched the heap. The run carries on, but the report says why and it exits with 1
+        void fail(const char *reason) {
+            std::lock_guard<std::recursive_mutex> guard(_lock);
+            if (!_failure) _failure = reason;
+        }
+
+        void print_report(std::FILE *out = stdout) {
+            std::lock_guard<std::recursive_mutex> guard(_lock);
+            std::fprintf(out, "\nSimulated %.3f ms at %.1f MHz\n", now_ns() / 1e6, cpu_frequency() / 1e6);
+            if (_failure) {
+                std::fprintf(out, "FAILED: %s\n", _failure);
+            }
+            for (uint8_t i = 0; i < DISPLAY_COUNT; i++) {
+                _displays[i].print_report(out, ENABLE_PIN_NAMES[i]);
+            }
+            if (_bus_contentions) {
+                std::fprintf(out, "%u bus contentions, the MCU and a display drove the data bus at the same time\n", _bus_contentions);
+            }
+            std::fflush(out);
+        }
+
+        int exit_code(void) const {
+            return _failure || (_strict && violations()) ? 1 : 0;
+        }
+
+    private:
+        std::recursive_mutex _lock;
+        uint64_t _clock_ps = 0;
+        uint64_t _picoseconds_per_cycle = 62500;        // 16MHz until a shim says otherwise
+        std::function<uint64_t(void)> _advance_hook;
+        uint64_t _next_event_ps = NEVER;
+        bool _in_advance_hook = false;
+
+        uint32_t _levels = 0;
+        Pin_Mode _modes[PIN_COUNT] = {};
+        std::atomic<uint64_t> _pin_changes{0};
+        uint64_t _gpio_calls = 0, _pin_transitions = 0;
+
+        std::vector<HD44780_Simulator> _displays;
+        uint32_t _bus_contentions = 0;
+        bool _contending = false;
+        const char *_failure = nullptr;
+        const bool _strict, _rw_grounded;
+
+        static bool option(const char *name) {
+            const char *value = std::getenv(name);
+            return value && value[0] != '\0' && value[0] != '0';
+        }
+
+        void advance_ps(uint64_t ps) {
+            std::lock_guard<std::recursive_mutex> guard(_lock);
+            uint64_t target_ps = _clock_ps + ps;
+
+            // Step through any timer events along the way. Time spent in an interrupt pushes back whatever it interrupted
+            while (_advance_hook && !_in_advance_hook && _next_event_ps <= target_ps) {
+                if (_next_event_ps > _clock_ps) {
+                    _clock_ps = _next_event_ps;
+                }
+                uint64_t started_ps = _clock_ps;
+                _in_advance_hook = true;
+                _next_event_ps = _advance_hook();
+                _in_advance_hook = false;
+                target_ps += _clock_ps - started_ps;
+            }
+            _clock_ps = target_ps;
+        }
+
+        // What the controllers see on the data bus: pins we drive, pulled up pins read HIGH and floating pins read LOW
+        uint8_t data_bus(void) const {
+            uint8_t value = 0;
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                uint8_t pin = DATA_BUS_PINS[bit];
+                bool level = _modes[pin] == mode_output ? bool(_levels & (1UL << pin)) : _modes[pin] == mode_input_pullup;
+                value |= level << bit;
+            }
+            return value;
+        }
+
+        bool driving_data_bus(void) const {
+            for (uint8_t pin : DATA_BUS_PINS) {
+                if (_modes[pin] == mode_output) return true;
+            }
+            return false;
+        }
+
+        void update_displays(void) {
+            bool rs = _levels & (1UL << REGISTER_SELECT_PIN);
+            bool rw = !_rw_grounded && (_levels & (1UL << READ_WRITE_PIN));
+            uint8_t data = data_bus();
+            bool contending = false;
+            for (uint8_t i = 0; i < DISPLAY_COUNT; i++) {
+                bool e = _levels & (1UL << ENABLE_PINS[i]);
+                _displays[i].sample(rs, rw, e, data, now_ns());
+                contending |= _displays[i].driving_bus() && driving_data_bus();
+            }
+            if (contending && !_contending) {
+                _bus_contentions++;
+            }
+            _contending = contending;
+        }
+};
+
+inline Simulated_Board simulated_board;
@@ -0,0 +1,403 @@
+#pragma once
+
+// Host stand in for Mbed OS. Just enough of the API for the labs to compile on Linux,
+// with every call driving the simulated board instead of real hardware.
+//
+// GPIO calls cost roughly what they do on a NUCLEO-F401RE running at 84MHz, and sleeping moves
+// the simulated clock on rather than sleeping for real.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "Simulated_Board.h"
+
+#define HOST_SIMULATOR 1
+#define MBED_MAJOR_VERSION 6
+
+// Pin names are encoded the way the STM32 targets do it, GPIO port in the high nibble and pin in the low one.
+// The Arduino header names are aliases for the pins they land on on a NUCLEO-F401RE
+enum PinName: uint32_t {
+    PA_0 = 0x00, PA_1, PA_2, PA_3, PA_4, PA_5, PA_6, PA_7, PA_8, PA_9, PA_10, PA_11, PA_12, PA_13, PA_14, PA_15,
+    PB_0 = 0x10, PB_1, PB_2, PB_3, PB_4, PB_5, PB_6, PB_7, PB_8, PB_9, PB_10, PB_11, PB_12, PB_13, PB_14, PB_15,
+    PC_0 = 0x20, PC_1, PC_2, PC_3, PC_4, PC_5, PC_6, PC_7, PC_8, PC_9, PC_10, PC_11, PC_12, PC_13, PC_14, PC_15,
+
+    D0 = PA_3, D1 = PA_2, D2 = PA_10, D3 = PB_3, D4 = PB_5, D5 = PB_4, D6 = PB_10, D7 = PA_8,
+    D8 = PA_9, D9 = PC_7, D10 = PB_6, D11 = PA_7, D12 = PA_6, D13 = PA_5, D14 = PB_9, D15 = PB_8,
+    A0 = PA_0, A1 = PA_1, A2 = PA_4, A3 = PB_0, A4 = PC_1, A5 = PC_0,
+
+    NC = 0xFFFFFFFF,
+};
+
+#define STM_PORT(X) (((uint32_t)(X) >> 4) & 0xF)
+#define STM_PIN(X)  ((uint32_t)(X) & 0xF)
+
+// Which simulated board pin (D0-D15 = 0-15, A0-A5 = 16-21) a pin name is wired to, or 0xFF if it isn't on the Arduino header
+inline uint8_t simulated_pin(PinName pin) {
+    static const PinName HEADER[Simulated_Board::PIN_COUNT] = {
+        D0, D1, D2, D3, D4, D5, D6, D7, D8, D9, D10, D11, D12, D13, D14, D15, A0, A1, A2, A3, A4, A5,
+    };
+    for (uint8_t i = 0; i < Simulated_Board::PIN_COUNT; i++) {
+        if (HEADER[i] == pin) return i;
+    }
+    return 0xFF;
+}
+
+enum PinMode {
+    PullNone,
+    PullUp,
+    PullDown,
+    PullDefault = PullNone,
+};
+
+// Approximate cost in CPU cycles of the Mbed GPIO classes on a Cortex-M4
+namespace mbed_costs {
+    constexpr uint32_t CPU_HZ = 84000000;
+    constexpr uint32_t GPIO_WRITE = 12;        // DigitalOut::write() through to the BSRR register
+    constexpr uint32_t GPIO_READ = 12;
+    constexpr uint32_t GPIO_DIR = 40;          // switching a pin between input and output
+    constexpr uint32_t BUS_LOCK = 120;         // BusOut and friends take and release a PlatformMutex on every access
+    constexpr uint32_t GPIO_REGISTER = 2;      // a load or store straight to a GPIO register on the AHB1 bus
+    constexpr uint32_t US_TICKER_READ = 20;    // us_ticker_read() reading the microsecond timer through the HAL
+}
+
+// The GPIO registers of ports A to C, for code that wants to skip the HAL. Only the registers the labs use are modelled:
+// MODER (2 bits per pin, 00 = input, 01 = output), PUPDR (2 bits per pin, 01 = pull up), IDR, ODR and BSRR
+// (writing the low half sets pins, the high half clears them, in one store that nothing can interrupt)
+class Simulated_GPIO_Register {
+    public:
+        enum Kind: uint8_t { moder, pupdr, idr, odr, bsrr };
+
+        constexpr Simulated_GPIO_Register(uint8_t port, Kind kind) : _port(port), _kind(kind) {}
+
+        operator uint32_t() const {
+            simulated_board.gpio_access(mbed_costs::GPIO_REGISTER);
+            return read();
+        }
+
+        Simulated_GPIO_Register &operator=(uint32_t value) {
+            simulated_board.gpio_access(mbed_costs::GPIO_REGISTER);
+            write(value);
+            return *this;
+        }
+
+        Simulated_GPIO_Register &operator|=(uint32_t value) { return *this = uint32_t(*this) | value; }
+        Simulated_GPIO_Register &operator&=(uint32_t value) { return *this = uint32_t(*this) & value; }
+
+    private:
+        const uint8_t _port;
+        const Kind _kind;
+
+        static inline uint32_t _pull_ups[3] = {};       // PUPDR isn't something the board keeps, so we remember it here
+
+        uint8_t board_pin(uint8_t bit) const {
+            return simulated_pin(PinName((_port << 4) | bit));
+        }
+
+        uint32_t read(void) const {
+            if (_kind == pupdr) return _pull_ups[_port];
+            if (_kind == bsrr) return 0;                // write only
+
+            uint32_t value = 0;
+            for (uint8_t bit = 0; bit < 16; bit++) {
+                uint8_t pin = board_pin(bit);
+                if (pin == 0xFF) continue;
+                Simulated_Board::Pin_Mode mode = simulated_board.mode(pin);
+                if (_kind == moder) value |= uint32_t(mode == Simulated_Board::mode_output) << (bit * 2);
+                if (_kind == odr) value |= uint32_t(simulated_board.level(pin)) << bit;
+                if (_kind == idr) value |= uint32_t(simulated_board.read_pin(pin)) << bit;
+            }
+            return value;
+        }
+
+        void write(uint32_t value) {
+            if (_kind == idr) return;                   // read only
+            if (_kind == pupdr) _pull_ups[_port] = value;
+
+            uint32_t pin_mask = 0, levels = 0;
+            for (uint8_t bit = 0; bit < 16; bit++) {
+                uint8_t pin = board_pin(bit);
+                if (pin == 0xFF) continue;
+
+                if (_kind == moder || _kind == pupdr) {
+                    bool output = _kind == moder ? ((value >> (bit * 2)) & 3) == 1 : simulated_board.mode(pin) == Simulated_Board::mode_output;
+                    bool pull_up = ((_pull_ups[_port] >> (bit * 2)) & 3) == 1;
+                    simulated_board.pin_mode(pin, output ? Simulated_Board::mode_output : pull_up ? Simulated_Board::mode_input_pullup : Simulated_Board::mode_input);
+                }
+                else if (_kind == odr) {
+                    pin_mask |= 1UL << pin;
+                    levels |= uint32_t((value >> bit) & 1) << pin;
+                }
+                else if ((value >> (bit + 16)) & 1 || (value >> bit) & 1) {
+                    pin_mask |= 1UL << pin;
+                    levels |= uint32_t((value >> bit) & 1) << pin;     // BSRR, set wins if a bit is in both halves
+                }
+            }
+            if (pin_mask) {
+                simulated_board.write_pins(pin_mask, levels);       // every pin on the port changes in the same instant
+            }
+        }
+};
+
+struct GPIO_TypeDef {
+    Simulated_GPIO_Register MODER, PUPDR, IDR, ODR, BSRR;
+};
+
+inline GPIO_TypeDef simulated_gpio_ports[3] = {
+    {{0, Simulated_GPIO_Register::moder}, {0, Simulated_GPIO_Register::pupdr}, {0, Simulated_GPIO_Register::idr}, {0, Simulated_GPIO_Register::odr}, {0, Simulated_GPIO_Register::bsrr}},
+    {{1, Simulated_GPIO_Register::moder}, {1, Simulated_GPIO_Register::pupdr}, {1, Simulated_GPIO_Register::idr}, {1, Simulated_GPIO_Register::odr}, {1, Simulated_GPIO_Register::bsrr}},
+    {{2, Simulated_GPIO_Register::moder}, {2, Simulated_GPIO_Register::pupdr}, {2, Simulated_GPIO_Register::idr}, {2, Simulated_GPIO_Register::odr}, {2, Simulated_GPIO_Register::bsrr}},
+};
+
+#define GPIOA (&simulated_gpio_ports[0])
+#define GPIOB (&simulated_gpio_ports[1])
+#define GPIOC (&simulated_gpio_ports[2])
+
+inline const bool mbed_clock_configured = (simulated_board.set_cpu_frequency(mbed_costs::CPU_HZ), true);
+inline uint32_t SystemCoreClock = mbed_costs::CPU_HZ;
+
+// The recursive mutex Mbed's drivers use to keep threads off each other's peripherals. Taking and giving it back costs
+// what one BusOut access spends on its own lock
+class PlatformMutex {
+    public:
+        void lock(void) {
+            simulated_board.advance_cycles(mbed_costs::BUS_LOCK / 2);
+            _mutex.lock();
+        }
+
+        void unlock(void) {
+            simulated_board.advance_cycles(mbed_costs::BUS_LOCK / 2);
+            _mutex.unlock();
+        }
+
+    private:
+        std::recursive_mutex _mutex;
+};
+
+namespace mbed {
+
+    class DigitalOut {
+        public:
+            DigitalOut(PinName pin, int value = 0) : _pin(pin) {
+                simulated_board.gpio_access(mbed_costs::GPIO_DIR);
+                simulated_board.pin_mode(simulated_pin(_pin), Simulated_Board::mode_output);
+                write(value);
+            }
+
+            void write(int value) {
+                simulated_board.gpio_access(mbed_costs::GPIO_WRITE);
+                simulated_board.write_pin(simulated_pin(_pin), value);
+            }
+
+            int read(void) {
+                simulated_board.gpio_access(mbed_costs::GPIO_READ);
+                return simulated_board.read_pin(simulated_pin(_pin));
+            }
+
+            int is_connected(void) { return _pin != NC; }
+
+            DigitalOut &operator=(int value) { write(value); return *this; }
+            operator int() { return read(); }
+
+        private:
+            PinName _pin;
+    };
+
+    class DigitalIn {
+        public:
+            DigitalIn(PinName pin, PinMode pull = PullDefault) : _pin(pin) { mode(pull); }
+
+            int read(void) {
+                simulated_board.gpio_access(mbed_costs::GPIO_READ);
+                return simulated_board.read_pin(simulated_pin(_pin));
+            }
+
+            void mode(PinMode pull) {
+                simulated_board.gpio_access(mbed_costs::GPIO_DIR);
+                simulated_board.pin_mode(simulated_pin(_pin), pull == PullUp ? Simulated_Board::mode_input_pullup : Simulated_Board::mode_input);
+            }
+
+            operator int() { return read(); }
+
+        private:
+            PinName _pin;
+    };
+
+    class BusOut {
+        public:
+            BusOut(PinName p0, PinName p1 = NC, PinName p2 = NC, PinName p3 = NC,
+                   PinName p4 = NC, PinName p5 = NC, PinName p6 = NC, PinName p7 = NC,
+                   PinName p8 = NC, PinName p9 = NC, PinName p10 = NC, PinName p11 = NC,
+                   PinName p12 = NC, PinName p13 = NC, PinName p14 = NC, PinName p15 = NC)
+                : _pins{p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15}
+            {
+                for (int i = 0; i < 16; i++) {
+                    if (_pins[i] == NC) continue;
+                    _mask |= 1 << i;
+                    simulated_board.gpio_access(mbed_costs::GPIO_DIR);
+                    simulated_board.pin_mode(simulated_pin(_pins[i]), Simulated_Board::mode_output);
+                }
+            }
+
+            // Like the real BusOut, each pin is written one after the other under the bus lock
+            void write(int value) {
+                simulated_board.advance_cycles(mbed_costs::BUS_LOCK);
+                for (int i = 0; i < 16; i++) {
+                    if (_pins[i] == NC) continue;
+                    simulated_board.gpio_access(mbed_costs::GPIO_WRITE);
+                    simulated_board.write_pin(simulated_pin(_pins[i]), (value >> i) & 1);
+                }
+                _value = value;
+            }
+
+            int read(void) {
+                simulated_board.advance_cycles(mbed_costs::BUS_LOCK);
+                int value = 0;
+                for (int i = 0; i < 16; i++) {
+                    if (_pins[i] == NC) continue;
+                    simulated_board.gpio_access(mbed_costs::GPIO_READ);
+                    value |= simulated_board.read_pin(simulated_pin(_pins[i])) << i;
+                }
+                return value;
+            }
+
+            int mask(void) { return _mask; }
+
+            BusOut &operator=(int value) { write(value); return *this; }
+            operator int() { return read(); }
+
+        private:
+            PinName _pins[16];
+            int _mask = 0;
+            int _value = 0;
+    };
+
+    // Counts in microseconds from the simulated clock
+    class Timer {
+        public:
+            void start(void) { if (!_running) { _started_ns = simulated_board.now_ns(); _running = true; } }
+            void stop(void) { if (_running) { _elapsed_ns += simulated_board.now_ns() - _started_ns; _running = false; } }
+            void reset(void) { _elapsed_ns = 0; _started_ns = simulated_board.now_ns(); }
+
+            std::chrono::microseconds elapsed_time(void) const {
+                uint64_t elapsed_ns = _elapsed_ns + (_running ? simulated_board.now_ns() - _started_ns : 0);
+                return std::chrono::microseconds(elapsed_ns / 1000);
+            }
+
+        private:
+            uint64_t _started_ns = 0, _elapsed_ns = 0;
+            bool _running = false;
+    };
+
+}
+
+enum osPriority {
+    osPriorityLow = 8,
+    osPriorityBelowNormal = 16,
+    osPriorityNormal = 24,
+    osPriorityAboveNormal = 32,
+    osPriorityHigh = 40,
+    osPriorityRealtime = 48,
+};
+
+typedef int32_t osStatus;
+constexpr osStatus osOK = 0;
+constexpr osStatus osErrorResource = -3;
+constexpr uint32_t OS_STACK_SIZE = 4096;
+
+namespace rtos {
+    namespace ThisThread {
+        template <typename Rep, typename Period>
+        void sleep_for(std::chrono::duration<Rep, Period> duration) {
+            simulated_board.advance_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        }
+
+        inline void yield(void) { std::this_thread::yield(); }
+    }
+
+    // A real thread on the host, so anything shared between threads gets the same workout it would under the RTOS, and more,
+    // because the host runs them truly in parallel. Priority and stack size are accepted and ignored. There is only one simulated
+    // clock, so a thread that sleeps moves time on for every thread, not just itself
+    class Thread {
+        public:
+            Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = OS_STACK_SIZE, unsigned char *stack_mem = nullptr, const char *name = nullptr) {
+                (void)priority; (void)stack_size; (void)stack_mem; (void)name;
+            }
+
+            ~Thread() {
+                if (_thread.joinable()) _thread.detach();
+            }
+
+            osStatus start(std::function<void(void)> task) {
+                if (_thread.joinable()) return osErrorResource;
+                _thread = std::thread(task);
+                return osOK;
+            }
+
+            osStatus join(void) {
+                if (!_thread.joinable()) return osErrorResource;
+                _thread.join();
+                return osOK;
+            }
+
+        private:
+            std::thread _thread;
+    };
+}
+
+// The free running microsecond counter every Mbed target has, straight from the HAL
+inline uint32_t us_ticker_read(void) {
+    simulated_board.advance_cycles(mbed_costs::US_TICKER_READ);
+    return uint32_t(simulated_board.now_ns() / 1000);
+}
+
+inline void wait_us(int us) {
+    simulated_board.advance_ns(us * 1000ULL);
+}
+
+inline void wait_ns(unsigned int ns) {
+    simulated_board.advance_ns(ns);
+}
+
+using namespace mbed;
+using namespace rtos;
+using namespace std::chrono_literals;
+
+// The application's main() runs on its own thread, because Mbed programs usually finish in an endless loop.
+// Once the pins have been quiet for a while (or HOST_SIM_RUN_MS of simulated time has passed) we report
+// what the displays saw and exit. Define HOST_SIM_NO_MAIN to bring your own main() instead
+#ifndef HOST_SIM_NO_MAIN
+int mbed_main(void);
+
+int main(void) {
+    std::atomic<bool> finished{false};
+    std::thread application([&finished] {
+        mbed_main();
+        finished = true;
+    });
+    application.detach();
+
+    const char *run_ms = std::getenv("HOST_SIM_RUN_MS");
+    uint64_t run_for_ns = (run_ms ? std::strtoull(run_ms, nullptr, 10) : 10000) * 1000000ULL;
+
+    uint64_t last_pin_changes = ~0ULL;
+    int quiet_checks = 0;
+    while (!finished && quiet_checks < 5 && simulated_board.now_ns() < run_for_ns) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        uint64_t pin_changes = simulated_board.pin_changes();
+        quiet_checks = pin_changes == last_pin_changes ? quiet_checks + 1 : 0;
+        last_pin_changes = pin_changes;
+    }
+
+    simulated_board.print_report();
+    std::fflush(stdout);
+    std::_Exit(simulated_board.exit_code());
+}
+
+#define main mbed_main
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <sys/types.h>
+
+namespace mbed {
+
+    // Host stand in for mbed::Stream. On the target printf() goes through an unbuffered FILE, which newlib
+    // formats into a temporary buffer and hands to write() in one go. write() then calls _putc() once per
+    // character under the stream lock, and we keep that shape here so overriding either behaves the same.
+    class Stream {
+        public:
+            Stream(const char *name = nullptr) { (void)name; }
+            virtual ~Stream() {}
+
+            int putc(int c) {
+                lock();
+                unsigned char value = c;
+                int result = write(&value, 1) == 1 ? c : EOF;
+                unlock();
+                return result;
+            }
+
+            int puts(const char *s) {
+                lock();
+                ssize_t written = write(s, std::strlen(s));
+                unlock();
+                return written < 0 ? EOF : 0;
+            }
+
+            int getc(void) {
+                lock();
+                int c = _getc();
+                unlock();
+                return c;
+            }
+
+            int printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+                std::va_list args;
+                va_start(args, format);
+                int result = vprintf(format, args);
+                va_end(args);
+                return result;
+            }
+
+            int vprintf(const char *format, std::va_list args) {
+                char buffer[256];
+                int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+                if (length < 0) return length;
+                lock();
+                write(buffer, (size_t)length < sizeof(buffer) ? length : sizeof(buffer) - 1);
+                unlock();
+                return length;
+            }
+
+        protected:
+            virtual ssize_t write(const void *buffer, size_t length) {
+                const char *ptr = (const char *)buffer;
+                const char *end = ptr + length;
+
+                lock();
+                while (ptr != end) {
+                    if (_putc(*ptr++) == EOF) {
+                        break;
+                    }
+                }
+                unlock();
+
+                return ptr - (const char *)buffer;
+            }
+
+            virtual ssize_t read(void *buffer, size_t length) {
+                char *ptr = (char *)buffer;
+                char *end = ptr + length;
+
+                lock();
+                while (ptr != end) {
+                    int c = _getc();
+                    if (c == EOF) break;
+                    *ptr++ = c;
+                }
+                unlock();
+
+                return ptr - (const char *)buffer;
+            }
+
+            virtual int _putc(int c) = 0;
+            virtual int _getc() = 0;
+
+            virtual void lock() {}
+            virtual void unlock() {}
+    };
+
+}
@@ -0,0 +1,278 @@
+#include <mbed.h>
+#include "platform/Stream.h"
+
+constexpr uint8_t BUS_WIDTH = 8;
+
+// On the STM32 targets a PinName is the GPIO port in the high nibble and the pin in the low one (STM_PORT() and STM_PIN()),
+// so with the pin as a template parameter the compiler can pick the port and the bit for us, with no gpio_t to look them up in.
+template <PinName PIN>
+inline GPIO_TypeDef *gpio_port(void) {
+    static_assert(STM_PORT(PIN) <= 2, "only GPIO ports A to C are on the Arduino header");
+    if constexpr (STM_PORT(PIN) == 0) return GPIOA;
+    else if constexpr (STM_PORT(PIN) == 1) return GPIOB;
+    else return GPIOC;
+}
+
+// BSRR sets the pins in its low half and clears the ones in its high half, in a single store. No read-modify-write, so nothing to lock
+template <PinName PIN>
+inline void write_pin(bool level) {
+    gpio_port<PIN>()->BSRR = level ? 1UL << STM_PIN(PIN) : 1UL << (STM_PIN(PIN) + 16);
+}
+
+// The data bus, with every pin fixed at compile time. There is nothing to store, so everything here is static
+template <PinName DB0, PinName DB1, PinName DB2, PinName DB3, PinName DB4, PinName DB5, PinName DB6, PinName DB7>
+class STM32_Bus {
+    public:
+        static void write(uint8_t value) {
+            write_port<0>(value);
+            write_port<1>(value);
+            write_port<2>(value);
+        }
+
+        static uint8_t read(void) {
+            return read_port<0>() | read_port<1>() | read_port<2>();
+        }
+
+        // Let the display drive the bus, DB7 gets a pull up so nothing answering reads as busy
+        static void release(void) {
+            set_direction<0>(false);
+            set_direction<1>(false);
+            set_direction<2>(false);
+            GPIO_TypeDef *port = gpio_port<DB7>();
+            port->PUPDR = (port->PUPDR & ~(3UL << (STM_PIN(DB7) * 2))) | (1UL << (STM_PIN(DB7) * 2));
+        }
+
+        // Drive the bus ourselves again
+        static void take(void) {
+            GPIO_TypeDef *port = gpio_port<DB7>();
+            port->PUPDR = port->PUPDR & ~(3UL << (STM_PIN(DB7) * 2));
+            set_direction<0>(true);
+            set_direction<1>(true);
+            set_direction<2>(true);
+        }
+
+    private:
+        constexpr static PinName _PINS[BUS_WIDTH] = {DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7};
+
+        // Which pins of a port belong to the bus, worked out by the compiler
+        constexpr static uint32_t port_mask(uint32_t port) {
+            uint32_t mask = 0;
+            for (uint8_t i = 0; i < BUS_WIDTH; i++) {
+                if (STM_PORT(_PINS[i]) == port) mask |= 1UL << STM_PIN(_PINS[i]);
+            }
+            return mask;
+        }
+
+        // Two bits per pin in MODER and PUPDR
+        constexpr static uint32_t port_mode_mask(uint32_t port) {
+            uint32_t mask = 0;
+            for (uint8_t i = 0; i < BUS_WIDTH; i++) {
+                if (STM_PORT(_PINS[i]) == port) mask |= 3UL << (STM_PIN(_PINS[i]) * 2);
+            }
+            return mask;
+        }
+
+        template <uint32_t PORT>
+        static GPIO_TypeDef *port_registers(void) {
+            if constexpr (PORT == 0) return GPIOA;
+            else if constexpr (PORT == 1) return GPIOB;
+            else return GPIOC;
+        }
+
+        template <uint32_t PORT>
+        static void write_port(uint8_t value) {
+            constexpr uint32_t MASK = port_mask(PORT);
+            if constexpr (MASK != 0) {              // ports the bus isn't on don't generate any code at all
+                uint32_t set = 0;
+                for (uint8_t i = 0; i < BUS_WIDTH; i++) {   // every test and shift here is a constant, so this unrolls into a handful of bit moves
+                    if (STM_PORT(_PINS[i]) == PORT && (value & (1 << i))) set |= 1UL << STM_PIN(_PINS[i]);
+                }
+                port_registers<PORT>()->BSRR = set | ((MASK & ~set) << 16);    // every bus pin on this port changes in the same store
+            }
+        }
+
+        template <uint32_t PORT>
+        static uint8_t read_port(void) {
+            constexpr uint32_t MASK = port_mask(PORT);
+            uint8_t value = 0;
+            if constexpr (MASK != 0) {
+                uint32_t levels = port_registers<PORT>()->IDR;
+                for (uint8_t i = 0; i < BUS_WIDTH; i++) {
+                    if (STM_PORT(_PINS[i]) == PORT && (levels & (1UL << STM_PIN(_PINS[i])))) value |= 1 << i;
+                }
+            }
+            return value;
+        }
+
+        template <uint32_t PORT>
+        static void set_direction(bool output) {
+            constexpr uint32_t MODE_MASK = port_mode_mask(PORT);
+            if constexpr (MODE_MASK != 0) {
+                constexpr uint32_t OUTPUT_MODE = MODE_MASK & 0x55555555;    // 01 in each pin's two bits is general purpose output, 00 is input
+                GPIO_TypeDef *port = port_registers<PORT>();
+                port->MODER = (port->MODER & ~MODE_MASK) | (output ? OUTPUT_MODE : 0);
+            }
+        }
+};
+
+// Device timings from the datasheet. Execution times are for fosc = 270kHz (Table 6), bus timings are from Figure 25.
+// Pass a different profile in as the last template parameter for a controller that runs slower, or a bus with long wires
+struct HD44780_Timing {
+    constexpr static unsigned int CLEAR_US = 1520;             // clear display and return home
+    constexpr static unsigned int INSTRUCTION_US = 37;         // everything else
+    constexpr static unsigned int DATA_WRITE_US = 37 + 4;      // writing data takes 37us, then tADD of 4us before the address counter moves
+    constexpr static unsigned int ADDRESS_SETUP_NS = 40;       // tAS, RS and RW must settle before E rises
+    constexpr static unsigned int ENABLE_PULSE_NS = 230;       // PWEH, E must stay HIGH this long. Also covers tDDR (160ns) on a read
+    constexpr static unsigned int DATA_HOLD_NS = 10;           // tH, the bus must not change straight after E falls
+    constexpr static unsigned int ENABLE_CYCLE_NS = 500;       // tcycE, from one rising edge of E to the next
+};
+
+// The whole wiring is part of the type, so two displays on different pins are different classes and can't trample each other's bus.
+// Use NC as the read/write pin on boards where RW is tied to ground, and every write is timed instead of polling the busy flag
+template <PinName RS, PinName RW, PinName E, PinName DB0, PinName DB1, PinName DB2, PinName DB3, PinName DB4, PinName DB5, PinName DB6, PinName DB7, typename Timing = HD44780_Timing>
+class LCD_Display: public Stream {
+    public:
+        typedef STM32_Bus<DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7> Bus;
+
+        LCD_Display(void) {
+            // Let the HAL turn the port clocks on and set the pins up as outputs, once. After that we go straight to the registers,
+            // so there is no need to keep the DigitalOut objects around
+            DigitalOut(RS, 0);
+            DigitalOut(E, 0);                       // E idles LOW, the display latches whatever is on the bus when it falls
+            if constexpr (RW != NC) {
+                DigitalOut(RW, 0);                  // LOW = Write mode, HIGH = Read Mode
+            }
+            BusOut(DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7).write(0);
+
+            // Initialise the display
+            write_byte(instr_fn_set, 0);
+            write_byte(instr_display_on_no_cursor_blink, 0);
+            write_byte(instr_entry_mode, 0);
+            write_byte(instr_clear_disp, 0);        // Clear the display (This also resets cursor position)
+        }
+
+        bool busy_flag_mode(void) { return _busy_flag_mode; }  // false if we are timing every instruction instead
+
+    private:
+        constexpr static unsigned int _BUSY_TIMEOUT_US = 3000;  // nothing takes longer than 1.53ms (2.16ms on a slow oscillator), so if we are still busy after this, nobody is answering
+
+        bool _busy_flag_mode = RW != NC;    // true = poll the busy flag before every write, false = wait out every write from Timing
+
+        enum LCD_Instructions: uint8_t {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+        };
+
+        static unsigned int execution_time_us(uint8_t instruction) {
+            return instruction <= instr_return_home ? Timing::CLEAR_US : Timing::INSTRUCTION_US;
+        }
+
+        static void pulse_enable(void) {
+            wait_ns(Timing::ADDRESS_SETUP_NS);
+            write_pin<E>(1);
+            wait_ns(Timing::ENABLE_PULSE_NS);
+            write_pin<E>(0);                        // the falling edge is what latches the command
+            wait_ns(Timing::DATA_HOLD_NS);
+        }
+
+        void write_byte(uint8_t value, bool register_select) {
+            if constexpr (RW != NC) {
+                if (_busy_flag_mode) {
+                    wait_until_ready();
+                }
+            }
+
+            write_pin<RS>(register_select);         // 0 = Instruction register selected, 1 = Data register selected
+            Bus::write(value);
+            pulse_enable();
+
+            if (!_busy_flag_mode) {
+                wait_us(register_select ? Timing::DATA_WRITE_US : execution_time_us(value));
+            }
+        }
+
+        void wait_until_ready(void) {
+            // Hand the data bus over to the display. DB7 gets a pull up, so if nothing is driving it we read busy and eventually time out
+            Bus::release();
+            write_pin<RS>(0);                       // the busy flag is read from the instruction register
+            write_pin<RW>(1);                       // LOW = Write mode, HIGH = Read Mode
+
+            Timer waiting;
+            waiting.start();
+            while (read_busy_flag()) {
+                if (waiting.elapsed_time().count() > _BUSY_TIMEOUT_US) {
+                    // RW is probably tied to ground, and every poll has just strobed whatever was floating on the bus into the display.
+                    // Fall back to timed mode for good, and give that junk instruction as long as the slowest one takes to finish.
+                    _busy_flag_mode = false;
+                    wait_us(Timing::CLEAR_US);
+                    break;
+                }
+            }
+
+            // Take the data bus back. E is already LOW, so the display has let go of it
+            write_pin<RW>(0);
+            Bus::take();
+        }
+
+        static bool read_busy_flag(void) {
+            wait_ns(Timing::ADDRESS_SETUP_NS);
+            write_pin<E>(1);                        // the display drives the bus for as long as E is HIGH
+            wait_ns(Timing::ENABLE_PULSE_NS);
+            bool busy = Bus::read() & 0x80;         // DB7 is the busy flag, DB0-DB6 hold the address counter
+            write_pin<E>(0);
+            wait_ns(Timing::ENABLE_CYCLE_NS - Timing::ENABLE_PULSE_NS - Timing::ADDRESS_SETUP_NS);    // at 84MHz we could poll again far sooner than the display allows
+            return busy;
+        }
+
+        // Stream implementation - provides printf() interface to write to display
+        int _putc(int value) {
+            write_byte(value, 1);
+            return value;
+        }
+        int _getc() { return -1; };
+};
+
+// Time putting RS and a byte on the bus many times over, and return how many CPU cycles each one took
+template <typename Bus_Writer>
+unsigned int cycles_per_byte(Bus_Writer write_bus) {
+    constexpr unsigned int BENCHMARK_BYTES = 4096;
+
+    Timer timer;
+    timer.start();
+    for (unsigned int value = 0; value < BENCHMARK_BYTES; value++) {
+        write_bus(value & 0xFF);
+    }
+    timer.stop();
+    return (unsigned long long)timer.elapsed_time().count() * (SystemCoreClock / 1000000) / BENCHMARK_BYTES;
+}
+
+int main() {
+    typedef LCD_Display<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_LCD_Display;
+    My_LCD_Display my_lcd_screen;
+
+    // E is LOW, so the display ignores everything we put on the bus here
+    DigitalOut register_select(D12);
+    BusOut data_bus(D9, D8, D7, D6, D5, D4, D3, D2);
+    unsigned int before = cycles_per_byte([&](uint8_t value) {
+        register_select = 1;
+        data_bus.write(value);              // how Lab 03-01 did it
+    });
+    unsigned int after = cycles_per_byte([&](uint8_t value) {
+        write_pin<D12>(1);
+        My_LCD_Display::Bus::write(value);
+    });
+
+    // Lab 03-01 kept three DigitalOuts and a pointer to a BusOut in every display, on the target each DigitalOut holds a whole gpio_t
+    printf("DigitalOut and BusOut: %u cycles per byte, pins known at compile time: %u cycles per byte\n", before, after);
+    printf("%u bytes per display, against %u for DigitalOuts and a BusOut pointer\n",
+        (unsigned int)sizeof(my_lcd_screen), (unsigned int)(sizeof(Stream) + 3 * sizeof(DigitalOut) + sizeof(BusOut *)));
+
+    my_lcd_screen.printf("Hello World!!");
+
+	while(true) {
+		// put your main code here, to run repeatedly:
+	}
+}
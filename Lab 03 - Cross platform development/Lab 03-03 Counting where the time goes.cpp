@@ -0,0 +1,413 @@
+#include <mbed.h>
+#include "platform/Stream.h"
+
+constexpr uint8_t BUS_WIDTH = 8;
+
+// On the STM32 targets a PinName is the GPIO port in the high nibble and the pin in the low one (STM_PORT() and STM_PIN()),
+// so with the pin as a template parameter the compiler can pick the port and the bit for us, with no gpio_t to look them up in.
+template <PinName PIN>
+inline GPIO_TypeDef *gpio_port(void) {
+    static_assert(STM_PORT(PIN) <= 2, "only GPIO ports A to C are on the Arduino header");
+    if constexpr (STM_PORT(PIN) == 0) return GPIOA;
+    else if constexpr (STM_PORT(PIN) == 1) return GPIOB;
+    else return GPIOC;
+}
+
+// BSRR sets the pins in its low half and clears the ones in its high half, in a single store. No read-modify-write, so nothing to lock
+template <PinName PIN>
+inline void write_pin(bool level) {
+    gpio_port<PIN>()->BSRR = level ? 1UL << STM_PIN(PIN) : 1UL << (STM_PIN(PIN) + 16);
+}
+
+// The data bus, with every pin fixed at compile time. There is nothing to store, so everything here is static
+template <PinName DB0, PinName DB1, PinName DB2, PinName DB3, PinName DB4, PinName DB5, PinName DB6, PinName DB7>
+class STM32_Bus {
+    public:
+        static void write(uint8_t value) {
+            write_port<0>(value);
+            write_port<1>(value);
+            write_port<2>(value);
+        }
+
+        static uint8_t read(void) {
+            return read_port<0>() | read_port<1>() | read_port<2>();
+        }
+
+        // Let the display drive the bus, DB7 gets a pull up so nothing answering reads as busy
+        static void release(void) {
+            set_direction<0>(false);
+            set_direction<1>(false);
+            set_direction<2>(false);
+            GPIO_TypeDef *port = gpio_port<DB7>();
+            port->PUPDR = (port->PUPDR & ~(3UL << (STM_PIN(DB7) * 2))) | (1UL << (STM_PIN(DB7) * 2));
+        }
+
+        // Drive the bus ourselves again
+        static void take(void) {
+            GPIO_TypeDef *port = gpio_port<DB7>();
+            port->PUPDR = port->PUPDR & ~(3UL << (STM_PIN(DB7) * 2));
+            set_direction<0>(true);
+            set_direction<1>(true);
+            set_direction<2>(true);
+        }
+
+    private:
+        constexpr static PinName _PINS[BUS_WIDTH] = {DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7};
+
+        // Which pins of a port belong to the bus, worked out by the compiler
+        constexpr static uint32_t port_mask(uint32_t port) {
+            uint32_t mask = 0;
+            for (uint8_t i = 0; i < BUS_WIDTH; i++) {
+                if (STM_PORT(_PINS[i]) == port) mask |= 1UL << STM_PIN(_PINS[i]);
+            }
+            return mask;
+        }
+
+        // Two bits per pin in MODER and PUPDR
+        constexpr static uint32_t port_mode_mask(uint32_t port) {
+            uint32_t mask = 0;
+            for (uint8_t i = 0; i < BUS_WIDTH; i++) {
+                if (STM_PORT(_PINS[i]) == port) mask |= 3UL << (STM_PIN(_PINS[i]) * 2);
+            }
+            return mask;
+        }
+
+        template <uint32_t PORT>
+        static GPIO_TypeDef *port_registers(void) {
+            if constexpr (PORT == 0) return GPIOA;
+            else if constexpr (PORT == 1) return GPIOB;
+            else return GPIOC;
+        }
+
+        template <uint32_t PORT>
+        static void write_port(uint8_t value) {
+            constexpr uint32_t MASK = port_mask(PORT);
+            if constexpr (MASK != 0) {              // ports the bus isn't on don't generate any code at all
+                uint32_t set = 0;
+                for (uint8_t i = 0; i < BUS_WIDTH; i++) {   // every test and shift here is a constant, so this unrolls into a handful of bit moves
+                    if (STM_PORT(_PINS[i]) == PORT && (value & (1 << i))) set |= 1UL << STM_PIN(_PINS[i]);
+                }
+                port_registers<PORT>()->BSRR = set | ((MASK & ~set) << 16);    // every bus pin on this port changes in the same store
+            }
+        }
+
+        template <uint32_t PORT>
+        static uint8_t read_port(void) {
+            constexpr uint32_t MASK = port_mask(PORT);
+            uint8_t value = 0;
+            if constexpr (MASK != 0) {
+                uint32_t levels = port_registers<PORT>()->IDR;
+                for (uint8_t i = 0; i < BUS_WIDTH; i++) {
+                    if (STM_PORT(_PINS[i]) == PORT && (levels & (1UL << STM_PIN(_PINS[i])))) value |= 1 << i;
+                }
+            }
+            return value;
+        }
+
+        template <uint32_t PORT>
+        static void set_direction(bool output) {
+            constexpr uint32_t MODE_MASK = port_mode_mask(PORT);
+            if constexpr (MODE_MASK != 0) {
+                constexpr uint32_t OUTPUT_MODE = MODE_MASK & 0x55555555;    // 01 in each pin's two bits is general purpose output, 00 is input
+                GPIO_TypeDef *port = port_registers<PORT>();
+                port->MODER = (port->MODER & ~MODE_MASK) | (output ? OUTPUT_MODE : 0);
+            }
+        }
+};
+
+// Device timings from the datasheet. Execution times are for fosc = 270kHz (Table 6), bus timings are from Figure 25.
+// Pass a different profile in as the last template parameter for a controller that runs slower, or a bus with long wires
+struct HD44780_Timing {
+    constexpr static unsigned int CLEAR_US = 1520;             // clear display and return home
+    constexpr static unsigned int INSTRUCTION_US = 37;         // everything else
+    constexpr static unsigned int DATA_WRITE_US = 37 + 4;      // writing data takes 37us, then tADD of 4us before the address counter moves
+    constexpr static unsigned int ADDRESS_SETUP_NS = 40;       // tAS, RS and RW must settle before E rises
+    constexpr static unsigned int ENABLE_PULSE_NS = 230;       // PWEH, E must stay HIGH this long. Also covers tDDR (160ns) on a read
+    constexpr static unsigned int DATA_HOLD_NS = 10;           // tH, the bus must not change straight after E falls
+    constexpr static unsigned int ENABLE_CYCLE_NS = 500;       // tcycE, from one rising edge of E to the next
+};
+
+// Instrumentation is picked with another template parameter. LCD_Display calls these hooks from its hot path, and inherits from
+// whichever one it is given, so this one costs nothing at all: every hook is an empty inline function the compiler throws away,
+// and with no members it doesn't even take up a byte of the display (the empty base class optimisation)
+struct No_Instrumentation {
+    void call_started(void) {}
+    void display_ready(void) {}
+    void byte_sent(uint8_t, bool) {}
+    void busy_flag_read(uint8_t) {}
+    void enable_pulsed(void) {}
+    void call_finished(void) {}
+};
+
+// The last few bus transactions and when they happened, kept in a ring so the newest always replaces the oldest
+enum Bus_Transaction_Kind: uint8_t {
+    instruction_write,
+    data_write,
+    status_read,                            // the busy flag and address counter
+};
+
+struct Bus_Transaction {
+    uint32_t at_us;                         // from us_ticker_read()
+    uint8_t value;
+    Bus_Transaction_Kind kind;
+};
+
+template <uint8_t DEPTH>
+class Bus_Trace {
+    public:
+        void record(uint8_t value, Bus_Transaction_Kind kind) {
+            _ring[_next] = {us_ticker_read(), value, kind};
+            _next = (_next + 1) % DEPTH;
+            if (_length < DEPTH) {
+                _length++;
+            }
+        }
+
+        uint8_t length(void) const { return _length; }
+
+        // Oldest first
+        const Bus_Transaction &operator[](uint8_t index) const {
+            return _ring[(_next + DEPTH - _length + index) % DEPTH];
+        }
+
+    private:
+        Bus_Transaction _ring[DEPTH];
+        uint8_t _next = 0, _length = 0;
+};
+
+// No trace at all, recording into it does nothing
+template <>
+class Bus_Trace<0> {
+    public:
+        void record(uint8_t, Bus_Transaction_Kind) {}
+        uint8_t length(void) const { return 0; }
+        const Bus_Transaction &operator[](uint8_t) const {
+            static const Bus_Transaction nothing = {};      // never asked for, there are length() == 0 of them
+            return nothing;
+        }
+};
+
+// Counts what the driver does and how long it keeps the caller waiting. With TRACE_DEPTH above zero it also keeps the last
+// TRACE_DEPTH bus transactions. The hooks that measure time read the microsecond ticker, a few dozen cycles each
+template <uint8_t TRACE_DEPTH = 0>
+class LCD_Instrumentation {
+    public:
+        uint32_t bytes_sent(void) const { return _instruction_writes + _data_writes; }
+        uint32_t instruction_writes(void) const { return _instruction_writes; }
+        uint32_t data_writes(void) const { return _data_writes; }
+        uint32_t enable_pulses(void) const { return _enable_pulses; }     // writes plus every poll of the busy flag
+        uint32_t waiting_us(void) const { return _waiting_us; }            // in total, waiting for the display to be ready
+        uint32_t longest_call_us(void) const { return _longest_call_us; } // the longest any one write kept its caller waiting
+        const Bus_Trace<TRACE_DEPTH> &trace(void) const { return _trace; }
+
+        void reset_counters(void) {
+            _instruction_writes = _data_writes = _enable_pulses = 0;
+            _waiting_us = _longest_call_us = 0;
+        }
+
+        // The hooks LCD_Display calls
+        void call_started(void) {
+            _call_started_us = us_ticker_read();
+        }
+
+        void display_ready(void) {
+            _waiting_us += us_ticker_read() - _call_started_us;
+        }
+
+        void byte_sent(uint8_t value, bool register_select) {
+            if (register_select) {
+                _data_writes++;
+            }
+            else {
+                _instruction_writes++;
+            }
+            _trace.record(value, register_select ? data_write : instruction_write);
+        }
+
+        void busy_flag_read(uint8_t status) {
+            _trace.record(status, status_read);
+        }
+
+        void enable_pulsed(void) {
+            _enable_pulses++;
+        }
+
+        void call_finished(void) {
+            uint32_t call_us = us_ticker_read() - _call_started_us;
+            if (call_us > _longest_call_us) {
+                _longest_call_us = call_us;
+            }
+        }
+
+    private:
+        uint32_t _instruction_writes = 0, _data_writes = 0, _enable_pulses = 0;
+        uint32_t _waiting_us = 0, _longest_call_us = 0;
+        uint32_t _call_started_us = 0;
+        Bus_Trace<TRACE_DEPTH> _trace;
+};
+
+// The whole wiring is part of the type, so two displays on different pins are different classes and can't trample each other's bus.
+// Use NC as the read/write pin on boards where RW is tied to ground, and every write is timed instead of polling the busy flag
+template <PinName RS, PinName RW, PinName E, PinName DB0, PinName DB1, PinName DB2, PinName DB3, PinName DB4, PinName DB5, PinName DB6, PinName DB7, typename Timing = HD44780_Timing, typename Instrumentation = No_Instrumentation>
+class LCD_Display: public Stream, private Instrumentation {
+    public:
+        typedef STM32_Bus<DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7> Bus;
+
+        LCD_Display(void) {
+            // Let the HAL turn the port clocks on and set the pins up as outputs, once. After that we go straight to the registers,
+            // so there is no need to keep the DigitalOut objects around
+            DigitalOut(RS, 0);
+            DigitalOut(E, 0);                       // E idles LOW, the display latches whatever is on the bus when it falls
+            if constexpr (RW != NC) {
+                DigitalOut(RW, 0);                  // LOW = Write mode, HIGH = Read Mode
+            }
+            BusOut(DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7).write(0);
+
+            // Initialise the display
+            write_byte(instr_fn_set, 0);
+            write_byte(instr_display_on_no_cursor_blink, 0);
+            write_byte(instr_entry_mode, 0);
+            write_byte(instr_clear_disp, 0);        // Clear the display (This also resets cursor position)
+        }
+
+        bool busy_flag_mode(void) { return _busy_flag_mode; }  // false if we are timing every instruction instead
+        Instrumentation &instrumentation(void) { return *this; }
+
+    private:
+        constexpr static unsigned int _BUSY_TIMEOUT_US = 3000;  // nothing takes longer than 1.53ms (2.16ms on a slow oscillator), so if we are still busy after this, nobody is answering
+
+        bool _busy_flag_mode = RW != NC;    // true = poll the busy flag before every write, false = wait out every write from Timing
+        uint32_t _ready_at_us = us_ticker_read() + Timing::CLEAR_US;   // when the display will have finished the last thing we sent it, in timed mode.
+                                                                    // Whoever had the display before us may have left a clear running
+
+        enum LCD_Instructions: uint8_t {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+        };
+
+        static unsigned int execution_time_us(uint8_t instruction) {
+            return instruction <= instr_return_home ? Timing::CLEAR_US : Timing::INSTRUCTION_US;
+        }
+
+        void pulse_enable(void) {
+            Instrumentation::enable_pulsed();
+            wait_ns(Timing::ADDRESS_SETUP_NS);
+            write_pin<E>(1);
+            wait_ns(Timing::ENABLE_PULSE_NS);
+            write_pin<E>(0);                        // the falling edge is what latches the command
+            wait_ns(Timing::DATA_HOLD_NS);
+        }
+
+        void write_byte(uint8_t value, bool register_select) {
+            Instrumentation::call_started();
+            if constexpr (RW != NC) {
+                if (_busy_flag_mode) {
+                    wait_until_ready();
+                }
+            }
+            if (!_busy_flag_mode) {
+                // Timed mode waits for the last write here rather than straight after it, so the wait is counted as waiting for the
+                // display, and anything the caller does in between comes off it
+                while ((int32_t)(us_ticker_read() - _ready_at_us) < 0) {}
+            }
+            Instrumentation::display_ready();
+
+            write_pin<RS>(register_select);         // 0 = Instruction register selected, 1 = Data register selected
+            Bus::write(value);
+            pulse_enable();
+            Instrumentation::byte_sent(value, register_select);
+
+            if (!_busy_flag_mode) {
+                // E fell within one tick of the reading, so round up by one
+                _ready_at_us = us_ticker_read() + 1 + (register_select ? Timing::DATA_WRITE_US : execution_time_us(value));
+            }
+            Instrumentation::call_finished();
+        }
+
+        void wait_until_ready(void) {
+            // Hand the data bus over to the display. DB7 gets a pull up, so if nothing is driving it we read busy and eventually time out
+            Bus::release();
+            write_pin<RS>(0);                       // the busy flag is read from the instruction register
+            write_pin<RW>(1);                       // LOW = Write mode, HIGH = Read Mode
+
+            Timer waiting;
+            waiting.start();
+            while (read_busy_flag()) {
+                if (waiting.elapsed_time().count() > _BUSY_TIMEOUT_US) {
+                    // RW is probably tied to ground, and every poll has just strobed whatever was floating on the bus into the display.
+                    // Fall back to timed mode for good, and give that junk instruction as long as the slowest one takes to finish.
+                    _busy_flag_mode = false;
+                    wait_us(Timing::CLEAR_US);
+                    break;
+                }
+            }
+
+            // Take the data bus back. E is already LOW, so the display has let go of it
+            write_pin<RW>(0);
+            Bus::take();
+        }
+
+        bool read_busy_flag(void) {
+            Instrumentation::enable_pulsed();
+            wait_ns(Timing::ADDRESS_SETUP_NS);
+            write_pin<E>(1);                        // the display drives the bus for as long as E is HIGH
+            wait_ns(Timing::ENABLE_PULSE_NS);
+            uint8_t status = Bus::read();           // DB7 is the busy flag, DB0-DB6 hold the address counter
+            write_pin<E>(0);
+            wait_ns(Timing::ENABLE_CYCLE_NS - Timing::ENABLE_PULSE_NS - Timing::ADDRESS_SETUP_NS);    // at 84MHz we could poll again far sooner than the display allows
+            Instrumentation::busy_flag_read(status);
+            return status & 0x80;
+        }
+
+        // Stream implementation - provides printf() interface to write to display
+        int _putc(int value) {
+            write_byte(value, 1);
+            return value;
+        }
+        int _getc() { return -1; };
+};
+
+// Time printing the same text on a display, and return how many CPU cycles each character took
+template <typename Display>
+unsigned int cycles_per_character(Display &lcd_screen) {
+    constexpr const char *TEXT = "0123456789ABCDEF";
+
+    Timer timer;
+    timer.start();
+    int characters = lcd_screen.printf("%s", TEXT);
+    timer.stop();
+    return (unsigned long long)timer.elapsed_time().count() * (SystemCoreClock / 1000000) / characters;
+}
+
+int main() {
+    // The same display and wiring, built with and without the instrumentation
+    typedef LCD_Display<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_LCD_Display;
+    typedef LCD_Display<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2, HD44780_Timing, LCD_Instrumentation<8>> My_Instrumented_LCD_Display;
+
+    My_LCD_Display my_lcd_screen;
+    unsigned int plain_cycles = cycles_per_character(my_lcd_screen);
+
+    My_Instrumented_LCD_Display my_instrumented_lcd_screen;         // runs the init sequence again on the same display, which is harmless
+    auto &counters = my_instrumented_lcd_screen.instrumentation();
+    counters.reset_counters();
+    unsigned int instrumented_cycles = cycles_per_character(my_instrumented_lcd_screen);
+
+    printf("Without instrumentation: %u bytes, %u cycles per character. With it: %u bytes, %u cycles per character\n",
+        (unsigned int)sizeof(my_lcd_screen), plain_cycles, (unsigned int)sizeof(my_instrumented_lcd_screen), instrumented_cycles);
+    printf("%lu bytes sent (%lu instructions, %lu data), %lu enable pulses, %lu us waiting for the display, longest call %lu us\n",
+        (unsigned long)counters.bytes_sent(), (unsigned long)counters.instruction_writes(), (unsigned long)counters.data_writes(),
+        (unsigned long)counters.enable_pulses(), (unsigned long)counters.waiting_us(), (unsigned long)counters.longest_call_us());
+
+    constexpr const char *KIND_NAMES[] = {"instruction", "data", "status"};
+    for (uint8_t i = 0; i < counters.trace().length(); i++) {
+        const Bus_Transaction &transaction = counters.trace()[i];
+        printf("  %lu us: %s 0x%02X\n", (unsigned long)transaction.at_us, KIND_NAMES[transaction.kind], transaction.value);
+    }
+
+	while(true) {
+		// put your main code here, to run repeatedly:
+	}
+}
@@ -0,0 +1,172 @@
+#include <mbed.h>
+#include "platform/Stream.h"
+
+// printf() on a Stream formats the whole line into a buffer and hands it to write() in one go. The write() Stream gives us then
+// calls our _putc() once per character, a virtual call each time, and in Lab 03-01 each of those slept for a whole millisecond.
+// Here we override write() itself, so a line goes out as one batch under one lock, and the display's own timing sets the pace
+class LCD_Display: public Stream {
+    public:
+        static constexpr uint8_t _BUS_WIDTH = 8;
+
+        LCD_Display(PinName register_sel_pin, PinName read_write_pin, PinName enable_pin, BusOut *ptr_to_data_bus);
+
+        // Like puts(), but with no FILE or format string in the way, and no newline added. The text goes straight into write()
+        int print_text(const char *text);
+
+    protected:
+        // Called once per printf(), puts() or print_text() with everything that is to be shown
+        ssize_t write(const void *buffer, size_t length) override;
+
+    private:
+        // Device control pins
+        DigitalOut _register_sel_pin, _read_write_pin, _enable_pin;
+        BusOut *_ptr_to_data_bus; // requires us to define our bus out in our main code, then point to it.
+
+        // Other threads may print to the same display, so each batch goes out whole, under this lock
+        PlatformMutex _mutex;
+
+        // Device timings. Execution times from the datasheet (Table 6, fosc = 270kHz), bus timings from Figure 25
+        constexpr static uint32_t _CLEAR_US = 1520;             // clear display and return home
+        constexpr static uint32_t _INSTRUCTION_US = 37;         // everything else
+        constexpr static uint32_t _DATA_WRITE_US = 37 + 4;      // writing data takes 37us, then tADD of 4us before the address counter moves
+        constexpr static uint32_t _TICKER_RESOLUTION_US = 1;    // us_ticker_read() can be up to one tick behind
+        constexpr static uint32_t _ADDRESS_SETUP_NS = 40;       // tAS, RS must settle before E rises
+        constexpr static uint32_t _ENABLE_PULSE_NS = 230;       // PWEH, E must stay HIGH this long
+        constexpr static uint32_t _DATA_HOLD_NS = 10;           // tH, the bus must not change straight after E falls
+
+        uint32_t _ready_at_us = 0;      // when the display will have finished the last thing we sent it
+
+        enum LCD_Instructions: uint8_t {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+        };
+
+        void pulse_enable(void);
+        void send_command(uint8_t command);
+        void send_instruction(uint8_t instruction);
+        void wait_until_ready(void);
+
+        // Stream implementation. write() does the work now, these are only here because Stream needs them
+        int _putc(int value);
+        int _getc() { return -1; };
+        void lock() override { _mutex.lock(); }
+        void unlock() override { _mutex.unlock(); }
+};
+
+LCD_Display::LCD_Display(PinName register_sel_pin, PinName read_write_pin, PinName enable_pin, BusOut *ptr_to_data_bus)
+    :  _register_sel_pin(register_sel_pin), _read_write_pin(read_write_pin), _enable_pin(enable_pin), _ptr_to_data_bus(ptr_to_data_bus)
+{
+    // Pin modes no longer need to be initialized as this is covered by the DigitalOut constructor, same for data bus
+    _enable_pin = 0;        // E idles LOW, the display latches whatever is on the bus when it falls
+    _read_write_pin = 0;    // LOW = Write mode, HIGH = Read Mode
+
+    // Initialise the display. Each instruction waits for the one before it, so there is no need to sleep after the clear
+    send_instruction(instr_fn_set);
+    send_instruction(instr_display_on_no_cursor_blink);
+    send_instruction(instr_entry_mode);
+    send_instruction(instr_clear_disp);     // Clear the display (This also resets cursor position)
+
+    // now that device is set up, we can set our register select to data, just note that if you want to change config mid execution, you will have to pull it low again
+    _register_sel_pin = 1;            // 0 = Instruction register selected, 1 = Data register selected
+}
+
+int LCD_Display::print_text(const char *text) {
+    return write(text, strlen(text));
+}
+
+ssize_t LCD_Display::write(const void *buffer, size_t length) {
+    const uint8_t *characters = (const uint8_t *)buffer;
+
+    lock();
+    for (size_t i = 0; i < length; i++) {
+        // The display is still busy with the last character while the next one goes onto the bus, it only looks when E falls
+        send_command(characters[i]);
+        wait_until_ready();
+        pulse_enable();
+        _ready_at_us = us_ticker_read() + _TICKER_RESOLUTION_US + _DATA_WRITE_US;
+    }
+    unlock();
+
+    return length;
+}
+
+void LCD_Display::pulse_enable(void) {
+    wait_ns(_ADDRESS_SETUP_NS);
+    _enable_pin = 1;
+    wait_ns(_ENABLE_PULSE_NS);
+    _enable_pin = 0;                        // the falling edge is what latches the command
+    wait_ns(_DATA_HOLD_NS);
+}
+
+void LCD_Display::send_command(uint8_t command) {
+    _ptr_to_data_bus->write(command);
+}
+
+void LCD_Display::send_instruction(uint8_t instruction) {
+    lock();
+    _register_sel_pin = 0;
+    send_command(instruction);
+    wait_until_ready();
+    pulse_enable();
+    _ready_at_us = us_ticker_read() + _TICKER_RESOLUTION_US + (instruction <= instr_return_home ? _CLEAR_US : _INSTRUCTION_US);
+    _register_sel_pin = 1;
+    unlock();
+}
+
+void LCD_Display::wait_until_ready(void) {
+    while ((int32_t)(us_ticker_read() - _ready_at_us) < 0) {
+        // The display has been working while we got the next byte ready, so this is only whatever time it has left
+    }
+}
+
+int LCD_Display::_putc(int value) {
+    uint8_t character = value;
+    write(&character, 1);
+    return value;
+}
+
+// How long it took to show each character, and how many that works out to per second
+void report(const char *name, Timer &timer, int characters) {
+    uint32_t elapsed_us = timer.elapsed_time().count();
+    printf("%s: %lu us for %d characters, %lu characters per second\n",
+        name, (unsigned long)elapsed_us, characters, (unsigned long)(characters * 1000000ULL / elapsed_us));
+}
+
+int main() {
+    BusOut DATA_BUS(D9, D8, D7, D6, D5, D4, D3, D2);
+    LCD_Display my_lcd_screen(D12, D11, D10, &DATA_BUS);
+    Timer timer;
+
+    // A character at a time, the way Lab 03-01 sent everything: a lock and a trip through write() for each one
+    const char *line = "Hello World!!   ";
+    timer.start();
+    for (const char *character = line; *character; character++) {
+        my_lcd_screen.putc(*character);
+    }
+    timer.stop();
+    report("putc()", timer, strlen(line));
+
+    // A whole formatted line, one batch. On the board the formatting costs a little on top, the simulator only charges for the pins
+    timer.reset();
+    timer.start();
+    int characters = my_lcd_screen.printf("%-10s%6d", "Uptime", 42);
+    timer.stop();
+    report("printf()", timer, characters);
+
+    // No formatting at all
+    timer.reset();
+    timer.start();
+    characters = my_lcd_screen.print_text("0123456789ABCDEF");
+    timer.stop();
+    report("print_text()", timer, characters);
+
+    printf("The display itself needs %lu us per character, %lu characters per second at most\n",
+        (unsigned long)(37 + 4), (unsigned long)(1000000 / (37 + 4)));
+
+	while(true) {
+		// put your main code here, to run repeatedly:
+	}
+}
@@ -0,0 +1,157 @@
+#include <Arduino.h>
+
+constexpr byte BUS_WIDTH = 8;
+constexpr byte NOT_CONNECTED = 0xFF;    // pass this in as the read/write pin on boards where RW is tied to ground
+
+class LCD_Display {
+    public:
+        LCD_Display(byte register_select_pin, byte read_write_pin, byte enable_pin, const byte data_bus_pins[]);
+        void print_text(const String text);
+        bool busy_flag_mode(void) { return _busy_flag_mode; }   // false if we are stuck with fixed delays
+
+    private:
+        // Device control pins
+        const byte _REGISTER_SELECT_PIN;
+        const byte _READ_WRITE_PIN;
+        const byte _ENABLE_PIN;
+
+        // Device data bus pins
+        static byte _data_bus_pins[BUS_WIDTH];     // declared static because other devices can share the same data bus, no need to have separate data busses for multiple devices.
+
+        // Device timings
+        constexpr static byte _CLEAR_DELAY_MS = 2; // clear display and return home instructions take 1.53ms to execute
+        constexpr static byte _INSTRUCTION_DELAY_MS = 1; // most instructions take 45us to execute, we'll force the MCU to wait
+        constexpr static unsigned long _BUSY_TIMEOUT_US = 3000; // nothing takes longer than 1.53ms (2.16ms on a slow oscillator), so if we are still busy after this, nobody is answering
+
+        bool _busy_flag_mode;   // true = poll the busy flag before every write, false = wait a fixed time after every write
+
+        enum LCD_Instructions: byte {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+        };
+
+        void pulse_enable(void);
+        void send_command(byte command);
+        void write_byte(byte value, byte register_select);
+        void wait_until_ready(void);
+        bool read_busy_flag(void);
+};
+
+byte LCD_Display::_data_bus_pins[BUS_WIDTH] = {0, 0, 0, 0, 0, 0, 0, 0}; // we are forced to initialize this static array, but can change it at any time during run time.
+
+LCD_Display::LCD_Display(byte register_select_pin, byte read_write_pin, byte enable_pin, const byte data_bus_pins[])
+    :  _REGISTER_SELECT_PIN(register_select_pin), _READ_WRITE_PIN(read_write_pin), _ENABLE_PIN(enable_pin), _busy_flag_mode(read_write_pin != NOT_CONNECTED)
+{
+    // Initialise the device control pins
+    pinMode(_REGISTER_SELECT_PIN, OUTPUT);
+    pinMode(_ENABLE_PIN, OUTPUT);
+    digitalWrite(_ENABLE_PIN, LOW);                 // E idles LOW, the display latches whatever is on the bus when it falls
+
+    if (_busy_flag_mode) {
+        pinMode(_READ_WRITE_PIN, OUTPUT);
+        digitalWrite(_READ_WRITE_PIN, LOW);         // LOW = Write mode, HIGH = Read Mode
+    }
+
+    // Initialise the data bus pins, setting the pin modes to output and setting the pins LOW by default
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        LCD_Display::_data_bus_pins[i] = data_bus_pins[i];
+        pinMode(_data_bus_pins[i], OUTPUT);
+        digitalWrite(_data_bus_pins[i], LOW);
+    }
+
+    // Initialise the display
+    write_byte(instr_fn_set, LOW);
+    write_byte(instr_display_on_no_cursor_blink, LOW);
+    write_byte(instr_entry_mode, LOW);
+
+    // Clear the display (This also resets cursor position)
+    write_byte(instr_clear_disp, LOW);
+    if (!_busy_flag_mode) {
+        delay(_CLEAR_DELAY_MS);                     // Sleep to allow the display to full initialize, in busy flag mode the next write will wait for it instead
+    }
+}
+
+void LCD_Display::print_text(const String text) {
+    for (byte i = 0; i < text.length(); i++) {
+        write_byte(text[i], HIGH);
+    }
+}
+
+void LCD_Display::pulse_enable(void) {
+    digitalWrite(_ENABLE_PIN, HIGH);
+    digitalWrite(_ENABLE_PIN, LOW);                 // the falling edge is what latches the command
+    if (!_busy_flag_mode) {
+        delay(_INSTRUCTION_DELAY_MS);               // no way of asking the display if it's done, so we'll force the MCU to wait
+    }
+}
+
+void LCD_Display::send_command(byte command) {
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        digitalWrite(LCD_Display::_data_bus_pins[i], (command >> i) & 1);
+    }
+}
+
+void LCD_Display::write_byte(byte value, byte register_select) {
+    wait_until_ready();
+    digitalWrite(_REGISTER_SELECT_PIN, register_select);   // LOW = Instruction register selected, HIGH = Data register selected
+    send_command(value);
+    pulse_enable();
+}
+
+void LCD_Display::wait_until_ready(void) {
+    if (!_busy_flag_mode) {
+        return;
+    }
+
+    // Hand the data bus over to the display. DB7 gets a pull up, so if nothing is driving it we read busy and eventually time out
+    for (byte i = 0; i < BUS_WIDTH - 1; i++) {
+        pinMode(_data_bus_pins[i], INPUT);
+    }
+    pinMode(_data_bus_pins[BUS_WIDTH - 1], INPUT_PULLUP);
+    digitalWrite(_REGISTER_SELECT_PIN, LOW);        // the busy flag is read from the instruction register
+    digitalWrite(_READ_WRITE_PIN, HIGH);            // LOW = Write mode, HIGH = Read Mode
+
+    unsigned long started_us = micros();
+    while (read_busy_flag()) {
+        if (micros() - started_us > _BUSY_TIMEOUT_US) {
+            // RW is probably tied to ground, and every poll has just strobed whatever was floating on the bus into the display.
+            // Fall back to fixed delays for good, and give that junk instruction time to finish before we carry on.
+            _busy_flag_mode = false;
+            break;
+        }
+    }
+
+    // Take the data bus back. E is already LOW, so the display has let go of it
+    digitalWrite(_READ_WRITE_PIN, LOW);
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        pinMode(_data_bus_pins[i], OUTPUT);
+    }
+
+    if (!_busy_flag_mode) {
+        delay(_CLEAR_DELAY_MS);
+    }
+}
+
+bool LCD_Display::read_busy_flag(void) {
+    digitalWrite(_ENABLE_PIN, HIGH);                // the display drives the bus for as long as E is HIGH
+    bool busy = digitalRead(_data_bus_pins[BUS_WIDTH - 1]);    // DB7 is the busy flag, DB0-DB6 hold the address counter
+    digitalWrite(_ENABLE_PIN, LOW);
+    return busy;
+}
+
+void setup() {
+    constexpr byte REGISTER_SELECT_PIN = D12;
+    constexpr byte READ_WRITE_PIN = D11;            // use NOT_CONNECTED here if RW is wired to ground
+    constexpr byte ENABLE_PIN = D10;
+    constexpr byte DATA_BUS[8] = {D9, D8, D7, D6, D5, D4, D3, D2};
+
+    LCD_Display my_lcd_screen(REGISTER_SELECT_PIN, READ_WRITE_PIN, ENABLE_PIN, DATA_BUS);
+    my_lcd_screen.print_text("Hello World!!");
+}
+
+void loop() {
+    // Do nothing for now
+}
@@ -0,0 +1,296 @@
+#include <Arduino.h>
+
+constexpr byte BUS_WIDTH = 8;
+constexpr byte DISPLAY_COLUMNS = 16;
+constexpr byte DISPLAY_ROWS = 2;
+constexpr byte NOT_CONNECTED = 0xFF;    // pass this in as the read/write pin on boards where RW is tied to ground
+
+typedef decltype(portOutputRegister(0)) port_register_pointer;     // volatile uint8_t * on AVR
+
+constexpr unsigned long cycles_for_ns(unsigned long ns) {
+    return (ns * (F_CPU / 1000000UL) + 999) / 1000;
+}
+
+class LCD_Display {
+    public:
+        LCD_Display(byte register_select_pin, byte read_write_pin, byte enable_pin, const byte data_bus_pins[]);
+
+        // Drawing only changes our copy of the screen, nothing goes out to the display until flush() is called
+        void set_cursor(byte column, byte row);
+        void print_text(const String text);
+        void clear(void);
+        void flush(void);
+        bool busy_flag_mode(void) { return _busy_flag_mode; }   // false if we are timing every instruction instead
+
+    private:
+        // Device control pins
+        const byte _REGISTER_SELECT_PIN;
+        const byte _READ_WRITE_PIN;
+        const byte _ENABLE_PIN;
+
+        // The enable strobe has to be timed to within a few hundred nanoseconds, far quicker than digitalWrite(), so we write its port directly
+        port_register_pointer _enable_port;
+        const byte _enable_mask;
+
+        // Device data bus pins
+        static byte _data_bus_pins[BUS_WIDTH];     // declared static because other devices can share the same data bus, no need to have separate data busses for multiple devices.
+
+        // Shadow copies of DDRAM. _screen is what we want showing, _on_display is what we know the display has
+        byte _screen[DISPLAY_ROWS][DISPLAY_COLUMNS];
+        byte _on_display[DISPLAY_ROWS][DISPLAY_COLUMNS];
+        byte _cursor_column = 0, _cursor_row = 0;
+        byte _address_counter = 0;      // where the display will put the next character, it moves along by one after every write
+        constexpr static byte _ROW_ADDRESS[DISPLAY_ROWS] = {0x00, 0x40};  // DDRAM address of the first character on each row
+
+        // Device timings. Execution times from the datasheet (Table 6, fosc = 270kHz), indexed by the highest bit set in the instruction
+        constexpr static unsigned int _EXECUTION_TIME_US[8] = {
+            1520,   // 0b00000001 clear display
+            1520,   // 0b0000001x return home
+            37,     // 0b000001xx entry mode set
+            37,     // 0b00001xxx display on/off control
+            37,     // 0b0001xxxx cursor or display shift
+            37,     // 0b001xxxxx function set
+            37,     // 0b01xxxxxx set CGRAM address
+            37,     // 0b1xxxxxxx set DDRAM address
+        };
+        constexpr static unsigned int _DATA_WRITE_TIME_US = 37 + 4;    // writing data takes 37us, then tADD of 4us before the address counter moves
+        constexpr static unsigned long _MICROS_RESOLUTION_US = 64000000UL / F_CPU;    // micros() counts in steps of 4us at 16MHz, so we allow for one extra step
+        constexpr static unsigned long _PULSE_TIME_US = 1;     // pulse_enable() takes well under 1us from start to the falling edge
+        constexpr static unsigned long _BUSY_TIMEOUT_US = 3000; // nothing takes longer than 1.53ms (2.16ms on a slow oscillator), so if we are still busy after this, nobody is answering
+
+        // Bus timings from the datasheet (Figure 25), converted to CPU cycles and rounded up
+        constexpr static unsigned long _ADDRESS_SETUP_CYCLES = cycles_for_ns(40);     // tAS, RS and RW must settle before E rises
+        constexpr static unsigned long _ENABLE_PULSE_CYCLES = cycles_for_ns(230);     // PWEH, E must stay HIGH this long. Also covers tDDR (160ns) on a read
+        constexpr static unsigned long _DATA_HOLD_CYCLES = cycles_for_ns(10);         // tH, the bus must not change straight after E falls
+
+        bool _busy_flag_mode;   // true = poll the busy flag before every write, false = time every write from the table above
+        unsigned long _ready_at_us = 0;     // when the display will have finished the last thing we sent it, in timed mode
+
+        enum LCD_Instructions: byte {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+            instr_set_ddram_addr                = 0b10000000, // 0x80 Set DDRAM address, OR the address into the lower 7 bits
+        };
+
+        static unsigned int execution_time_us(byte instruction);
+        void pulse_enable(void);
+        void send_command(byte command);
+        void write_byte(byte value, byte register_select);
+        void wait_until_ready(void);
+        bool read_busy_flag(void);
+};
+
+byte LCD_Display::_data_bus_pins[BUS_WIDTH] = {0, 0, 0, 0, 0, 0, 0, 0}; // we are forced to initialize this static array, but can change it at any time during run time.
+
+LCD_Display::LCD_Display(byte register_select_pin, byte read_write_pin, byte enable_pin, const byte data_bus_pins[])
+    :  _REGISTER_SELECT_PIN(register_select_pin), _READ_WRITE_PIN(read_write_pin), _ENABLE_PIN(enable_pin),
+       _enable_port(portOutputRegister(digitalPinToPort(enable_pin))), _enable_mask(digitalPinToBitMask(enable_pin)),
+       _busy_flag_mode(read_write_pin != NOT_CONNECTED)
+{
+    // Initialise the device control pins
+    pinMode(_REGISTER_SELECT_PIN, OUTPUT);
+    pinMode(_ENABLE_PIN, OUTPUT);
+    digitalWrite(_ENABLE_PIN, LOW);                 // E idles LOW, the display latches whatever is on the bus when it falls
+
+    if (_busy_flag_mode) {
+        pinMode(_READ_WRITE_PIN, OUTPUT);
+        digitalWrite(_READ_WRITE_PIN, LOW);         // LOW = Write mode, HIGH = Read Mode
+    }
+
+    // Initialise the data bus pins, setting the pin modes to output and setting the pins LOW by default
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        LCD_Display::_data_bus_pins[i] = data_bus_pins[i];
+        pinMode(_data_bus_pins[i], OUTPUT);
+        digitalWrite(_data_bus_pins[i], LOW);
+    }
+
+    // Initialise the display. Each write waits for the one before it, so there is no need to sleep after the clear any more
+    write_byte(instr_fn_set, LOW);
+    write_byte(instr_display_on_no_cursor_blink, LOW);
+    write_byte(instr_entry_mode, LOW);
+    write_byte(instr_clear_disp, LOW);              // Clear the display (This also resets cursor position)
+
+    // The display is now blank with the address counter at the start of the first row, and our copies have to match
+    for (byte row = 0; row < DISPLAY_ROWS; row++) {
+        for (byte column = 0; column < DISPLAY_COLUMNS; column++) {
+            _screen[row][column] = ' ';
+            _on_display[row][column] = ' ';
+        }
+    }
+}
+
+void LCD_Display::set_cursor(byte column, byte row) {
+    _cursor_column = column < DISPLAY_COLUMNS ? column : DISPLAY_COLUMNS;
+    _cursor_row = row < DISPLAY_ROWS ? row : DISPLAY_ROWS - 1;
+}
+
+void LCD_Display::print_text(const String text) {
+    // Anything past the end of the row is cut off
+    for (byte i = 0; i < text.length() && _cursor_column < DISPLAY_COLUMNS; i++) {
+        _screen[_cursor_row][_cursor_column++] = text[i];
+    }
+}
+
+void LCD_Display::clear(void) {
+    for (byte row = 0; row < DISPLAY_ROWS; row++) {
+        for (byte column = 0; column < DISPLAY_COLUMNS; column++) {
+            _screen[row][column] = ' ';
+        }
+    }
+    set_cursor(0, 0);
+}
+
+void LCD_Display::flush(void) {
+    for (byte row = 0; row < DISPLAY_ROWS; row++) {
+        for (byte column = 0; column < DISPLAY_COLUMNS; column++) {
+            if (_screen[row][column] == _on_display[row][column]) {
+                continue;
+            }
+
+            // Get the address counter to this cell, either by rewriting the unchanged cells in between and letting it
+            // count along by itself, or with a set DDRAM address instruction, whichever the display gets through quicker
+            byte address = _ROW_ADDRESS[row] + column;
+            byte gap = address - _address_counter;
+            bool same_row = _address_counter >= _ROW_ADDRESS[row] && _address_counter < address;
+
+            if (same_row && gap * _DATA_WRITE_TIME_US < execution_time_us(instr_set_ddram_addr)) {
+                for (byte skipped = column - gap; skipped < column; skipped++) {
+                    write_byte(_on_display[row][skipped], HIGH);
+                }
+            }
+            else if (address != _address_counter) {
+                write_byte(instr_set_ddram_addr | address, LOW);
+            }
+
+            write_byte(_screen[row][column], HIGH);
+            _on_display[row][column] = _screen[row][column];
+            _address_counter = address + 1;
+        }
+    }
+}
+
+unsigned int LCD_Display::execution_time_us(byte instruction) {
+    byte highest_bit = 7;
+    while (highest_bit > 0 && !(instruction & (1 << highest_bit))) {
+        highest_bit--;
+    }
+    return _EXECUTION_TIME_US[highest_bit];
+}
+
+void LCD_Display::pulse_enable(void) {
+    // E shares its port with other pins, so nothing may touch that port between our read and write. This also keeps the pulse exactly as long as we asked
+    noInterrupts();
+    __builtin_avr_delay_cycles(_ADDRESS_SETUP_CYCLES);
+    *_enable_port |= _enable_mask;
+    __builtin_avr_delay_cycles(_ENABLE_PULSE_CYCLES);
+    *_enable_port &= ~_enable_mask;                 // the falling edge is what latches the command
+    __builtin_avr_delay_cycles(_DATA_HOLD_CYCLES);
+    interrupts();
+}
+
+void LCD_Display::send_command(byte command) {
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        digitalWrite(LCD_Display::_data_bus_pins[i], (command >> i) & 1);
+    }
+}
+
+void LCD_Display::write_byte(byte value, byte register_select) {
+    if (_busy_flag_mode) {
+        wait_until_ready();
+    }
+
+    digitalWrite(_REGISTER_SELECT_PIN, register_select);   // LOW = Instruction register selected, HIGH = Data register selected
+    send_command(value);
+
+    if (_busy_flag_mode) {
+        pulse_enable();
+        return;
+    }
+
+    // The display has been executing the last command while we set up this one, so we only wait for whatever time is left
+    unsigned long now_us;
+    do {
+        now_us = micros();
+    } while ((long)(now_us - _ready_at_us) < 0);
+
+    pulse_enable();
+
+    // Rather than sleeping now, note when the display will be done and let the caller get on with something else.
+    // E fell within one micros() step of now_us, plus the pulse itself
+    _ready_at_us = now_us + _MICROS_RESOLUTION_US + _PULSE_TIME_US + (register_select ? _DATA_WRITE_TIME_US : execution_time_us(value));
+}
+
+void LCD_Display::wait_until_ready(void) {
+    // Hand the data bus over to the display. DB7 gets a pull up, so if nothing is driving it we read busy and eventually time out
+    for (byte i = 0; i < BUS_WIDTH - 1; i++) {
+        pinMode(_data_bus_pins[i], INPUT);
+    }
+    pinMode(_data_bus_pins[BUS_WIDTH - 1], INPUT_PULLUP);
+    digitalWrite(_REGISTER_SELECT_PIN, LOW);        // the busy flag is read from the instruction register
+    digitalWrite(_READ_WRITE_PIN, HIGH);            // LOW = Write mode, HIGH = Read Mode
+
+    unsigned long started_us = micros();
+    while (read_busy_flag()) {
+        if (micros() - started_us > _BUSY_TIMEOUT_US) {
+            // RW is probably tied to ground, and every poll has just strobed whatever was floating on the bus into the display.
+            // Fall back to timed mode for good, and give that junk instruction as long as the slowest one takes to finish.
+            _busy_flag_mode = false;
+            _ready_at_us = micros() + _MICROS_RESOLUTION_US + _EXECUTION_TIME_US[0];
+            break;
+        }
+    }
+
+    // Take the data bus back. E is already LOW, so the display has let go of it
+    digitalWrite(_READ_WRITE_PIN, LOW);
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        pinMode(_data_bus_pins[i], OUTPUT);
+    }
+}
+
+bool LCD_Display::read_busy_flag(void) {
+    noInterrupts();
+    __builtin_avr_delay_cycles(_ADDRESS_SETUP_CYCLES);
+    *_enable_port |= _enable_mask;                  // the display drives the bus for as long as E is HIGH
+    __builtin_avr_delay_cycles(_ENABLE_PULSE_CYCLES);
+    interrupts();
+    bool busy = digitalRead(_data_bus_pins[BUS_WIDTH - 1]);    // DB7 is the busy flag, DB0-DB6 hold the address counter
+    noInterrupts();
+    *_enable_port &= ~_enable_mask;
+    interrupts();
+    return busy;
+}
+
+LCD_Display *my_lcd_screen;
+unsigned long last_update_ms = 0;
+
+void setup() {
+    constexpr byte REGISTER_SELECT_PIN = D12;
+    constexpr byte READ_WRITE_PIN = NOT_CONNECTED;  // timed mode. Use D11 here to poll the busy flag instead, RW must be held LOW if it is wired up but not used
+    constexpr byte ENABLE_PIN = D10;
+    constexpr byte DATA_BUS[8] = {D9, D8, D7, D6, D5, D4, D3, D2};
+
+    static LCD_Display lcd_screen(REGISTER_SELECT_PIN, READ_WRITE_PIN, ENABLE_PIN, DATA_BUS);   // static, so it outlives setup() and loop() can use it
+    my_lcd_screen = &lcd_screen;
+
+    my_lcd_screen->print_text("Hello World!!");
+    my_lcd_screen->set_cursor(0, 1);
+    my_lcd_screen->print_text("Uptime:");
+    my_lcd_screen->flush();
+}
+
+void loop() {
+    // Redraw the whole screen ten times a second, only the digits that changed actually go out to the display
+    if (millis() - last_update_ms < 100) {
+        return;
+    }
+    last_update_ms = millis();
+
+    my_lcd_screen->clear();
+    my_lcd_screen->print_text("Hello World!!");
+    my_lcd_screen->set_cursor(0, 1);
+    my_lcd_screen->print_text("Uptime: " + String(last_update_ms / 100));
+    my_lcd_screen->flush();
+}
@@ -0,0 +1,288 @@
+#include <Arduino.h>
+
+constexpr byte BUS_WIDTH = 8;
+constexpr byte QUEUE_SIZE = 64;         // bytes waiting to go out to the display, must be a power of two so the indexes can wrap with a mask
+constexpr unsigned int TICK_US = 50;    // how often the timer interrupt sends something. Just longer than a data write takes (41us)
+
+typedef decltype(portOutputRegister(0)) port_register_pointer;     // volatile uint8_t * on AVR
+
+constexpr unsigned long cycles_for_ns(unsigned long ns) {
+    return (ns * (F_CPU / 1000000UL) + 999) / 1000;
+}
+
+class LCD_Display {
+    public:
+        // What print_text() should do when the queue is full
+        enum Overflow_Policy: byte {
+            wait_for_space,     // back pressure, the caller waits for the interrupt to make room. Nothing is lost
+            drop_output,        // return straight away and throw away anything that doesn't fit whole. The caller never waits
+        };
+
+        LCD_Display(byte register_select_pin, byte enable_pin, const byte data_bus_pins[]);
+        void print_text(const String text);
+        void set_cursor(byte column, byte row);
+        void flush(void);       // wait until everything queued so far has been shown
+
+        void set_overflow_policy(Overflow_Policy policy) { _overflow_policy = policy; }
+        byte queue_depth(void) { return (byte)(_queue_head - _queue_tail) & (QUEUE_SIZE - 1); }
+        byte queue_space(void) { return QUEUE_SIZE - 1 - queue_depth(); }     // one slot is always left empty, see enqueue()
+        byte high_water_mark(void) { return _high_water_mark; }     // the deepest the queue has been, to help choose QUEUE_SIZE
+        void reset_high_water_mark(void) { _high_water_mark = queue_depth(); }
+        unsigned long dropped(void) { return _dropped; }
+
+        static void service_interrupt(void);    // called from the timer interrupt, sends the next byte in the queue if the display is ready for it
+
+    private:
+        // Device control pins. RW must be tied to ground, we can't read the busy flag from inside an interrupt so we time every write instead
+        const byte _REGISTER_SELECT_PIN;
+        const byte _ENABLE_PIN;
+
+        // The enable strobe has to be timed to within a few hundred nanoseconds, far quicker than digitalWrite(), so we write its port directly
+        port_register_pointer _enable_port;
+        const byte _enable_mask;
+
+        // Device data bus pins
+        static byte _data_bus_pins[BUS_WIDTH];     // declared static because other devices can share the same data bus, no need to have separate data busses for multiple devices.
+
+        // Only one display can own the timer interrupt, this is the one it drains
+        static LCD_Display *_active_display;
+
+        // Device timings. Execution times from the datasheet (Table 6, fosc = 270kHz), indexed by the highest bit set in the instruction
+        constexpr static unsigned int _EXECUTION_TIME_US[8] = {
+            1520,   // 0b00000001 clear display
+            1520,   // 0b0000001x return home
+            37,     // 0b000001xx entry mode set
+            37,     // 0b00001xxx display on/off control
+            37,     // 0b0001xxxx cursor or display shift
+            37,     // 0b001xxxxx function set
+            37,     // 0b01xxxxxx set CGRAM address
+            37,     // 0b1xxxxxxx set DDRAM address
+        };
+        constexpr static unsigned int _DATA_WRITE_TIME_US = 37 + 4;    // writing data takes 37us, then tADD of 4us before the address counter moves
+
+        // Bus timings from the datasheet (Figure 25), converted to CPU cycles and rounded up
+        constexpr static unsigned long _ADDRESS_SETUP_CYCLES = cycles_for_ns(40);     // tAS, RS and RW must settle before E rises
+        constexpr static unsigned long _ENABLE_PULSE_CYCLES = cycles_for_ns(230);     // PWEH, E must stay HIGH this long
+        constexpr static unsigned long _DATA_HOLD_CYCLES = cycles_for_ns(10);         // tH, the bus must not change straight after E falls
+
+        // Timer1 counts at F_CPU / 8 and fires when it reaches OCR1A, then starts again from zero (CTC mode). Timer0 is left alone for millis() and micros()
+        constexpr static unsigned int _TIMER_COMPARE = (F_CPU / 8 / 1000000UL) * TICK_US - 1;
+
+        // The queue. print_text() only ever moves the head, and the interrupt only ever moves the tail, so neither needs a lock to read the other.
+        // Bytes are written and read in one instruction on AVR, which is why the indexes are bytes.
+        volatile byte _queue_values[QUEUE_SIZE];
+        volatile byte _queue_register_selects[QUEUE_SIZE];
+        volatile byte _queue_head = 0;          // where the next byte goes in
+        volatile byte _queue_tail = 0;          // where the interrupt takes the next byte out
+        volatile byte _ticks_to_wait = 0;       // ticks left before the display has finished the last thing we sent it
+
+        Overflow_Policy _overflow_policy = wait_for_space;
+        byte _high_water_mark = 0;
+        unsigned long _dropped = 0;
+
+        enum LCD_Instructions: byte {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+            instr_set_ddram_addr                = 0b10000000, // 0x80 Set DDRAM address, OR the address into the low 7 bits
+        };
+
+        static unsigned int execution_time_us(byte instruction);
+        void pulse_enable(void);
+        void send_command(byte command);
+        void write_byte(byte value, byte register_select);
+        bool enqueue(byte value, byte register_select);
+        void start_interrupt(void);
+};
+
+byte LCD_Display::_data_bus_pins[BUS_WIDTH] = {0, 0, 0, 0, 0, 0, 0, 0}; // we are forced to initialize this static array, but can change it at any time during run time.
+LCD_Display *LCD_Display::_active_display = nullptr;
+
+LCD_Display::LCD_Display(byte register_select_pin, byte enable_pin, const byte data_bus_pins[])
+    :  _REGISTER_SELECT_PIN(register_select_pin), _ENABLE_PIN(enable_pin),
+       _enable_port(portOutputRegister(digitalPinToPort(enable_pin))), _enable_mask(digitalPinToBitMask(enable_pin))
+{
+    // Initialise the device control pins
+    pinMode(_REGISTER_SELECT_PIN, OUTPUT);
+    pinMode(_ENABLE_PIN, OUTPUT);
+    digitalWrite(_ENABLE_PIN, LOW);                 // E idles LOW, the display latches whatever is on the bus when it falls
+
+    // Initialise the data bus pins, setting the pin modes to output and setting the pins LOW by default
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        LCD_Display::_data_bus_pins[i] = data_bus_pins[i];
+        pinMode(_data_bus_pins[i], OUTPUT);
+        digitalWrite(_data_bus_pins[i], LOW);
+    }
+
+    // Set up the timer, but leave its interrupt off until there is something in the queue
+    _active_display = this;
+    noInterrupts();
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM12) | _BV(CS11);                // CTC mode, prescaler of 8
+    OCR1A = _TIMER_COMPARE;
+    TCNT1 = 0;
+    interrupts();
+
+    // Initialise the display. From here on only the interrupt touches the bus, so these go through the queue like everything else
+    enqueue(instr_fn_set, LOW);
+    enqueue(instr_display_on_no_cursor_blink, LOW);
+    enqueue(instr_entry_mode, LOW);
+    enqueue(instr_clear_disp, LOW);                 // Clear the display (This also resets cursor position)
+}
+
+void LCD_Display::print_text(const String text) {
+    // Half a line on the screen is worse than the old line staying up a little longer, so when we can't wait, the text goes in whole or not at all.
+    // The interrupt only ever makes more room, so once there is space for all of it, it will all fit
+    if (_overflow_policy == drop_output && queue_space() < text.length()) {
+        _dropped += text.length();
+        return;
+    }
+    for (byte i = 0; i < text.length(); i++) {
+        enqueue(text[i], HIGH);
+    }
+}
+
+void LCD_Display::set_cursor(byte column, byte row) {
+    constexpr byte ROW_ADDRESS[2] = {0x00, 0x40};
+    if (!enqueue(instr_set_ddram_addr | (ROW_ADDRESS[row & 1] + column), LOW)) {
+        _dropped++;
+    }
+}
+
+void LCD_Display::flush(void) {
+    // The interrupt turns itself off once the queue is empty and the display has finished the last byte
+    while (TIMSK1 & _BV(OCIE1A)) {
+        yield();
+    }
+}
+
+bool LCD_Display::enqueue(byte value, byte register_select) {
+    while (queue_depth() == QUEUE_SIZE - 1) {       // one slot is always left empty, otherwise a full queue would look the same as an empty one
+        if (_overflow_policy == drop_output) {
+            return false;
+        }
+        yield();                                    // the interrupt is already running, it will make room
+    }
+
+    byte head = _queue_head;
+    _queue_values[head] = value;
+    _queue_register_selects[head] = register_select;
+    _queue_head = (head + 1) & (QUEUE_SIZE - 1);    // only now can the interrupt see it
+
+    byte depth = queue_depth();
+    if (depth > _high_water_mark) {
+        _high_water_mark = depth;
+    }
+
+    start_interrupt();
+    return true;
+}
+
+void LCD_Display::start_interrupt(void) {
+    // The interrupt may be switching itself off at this very moment, so don't let it run in the middle of our read-modify-write
+    noInterrupts();
+    TIMSK1 |= _BV(OCIE1A);
+    interrupts();
+}
+
+void LCD_Display::service_interrupt(void) {
+    LCD_Display *display = _active_display;
+
+    // Still working on the last thing we sent it
+    if (display->_ticks_to_wait > 0) {
+        display->_ticks_to_wait--;
+        return;
+    }
+
+    byte tail = display->_queue_tail;
+    if (tail == display->_queue_head) {
+        TIMSK1 &= ~_BV(OCIE1A);                     // nothing left to send, and nothing still running, so stop interrupting until there is
+        return;
+    }
+
+    byte value = display->_queue_values[tail];
+    byte register_select = display->_queue_register_selects[tail];
+    display->_queue_tail = (tail + 1) & (QUEUE_SIZE - 1);
+    display->write_byte(value, register_select);
+
+    // One tick is always enough for a data write, slower instructions such as clear display skip however many more ticks they need
+    unsigned int execution_us = register_select ? _DATA_WRITE_TIME_US : execution_time_us(value);
+    display->_ticks_to_wait = (execution_us + TICK_US - 1) / TICK_US - 1;
+}
+
+ISR(TIMER1_COMPA_vect) {
+    LCD_Display::service_interrupt();
+}
+
+unsigned int LCD_Display::execution_time_us(byte instruction) {
+    byte highest_bit = 7;
+    while (highest_bit > 0 && !(instruction & (1 << highest_bit))) {
+        highest_bit--;
+    }
+    return _EXECUTION_TIME_US[highest_bit];
+}
+
+void LCD_Display::pulse_enable(void) {
+    // Only ever called from the interrupt, where interrupts are already off, so nothing else can touch the port between our read and write
+    __builtin_avr_delay_cycles(_ADDRESS_SETUP_CYCLES);
+    *_enable_port |= _enable_mask;
+    __builtin_avr_delay_cycles(_ENABLE_PULSE_CYCLES);
+    *_enable_port &= ~_enable_mask;                 // the falling edge is what latches the command
+    __builtin_avr_delay_cycles(_DATA_HOLD_CYCLES);
+}
+
+void LCD_Display::send_command(byte command) {
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        digitalWrite(LCD_Display::_data_bus_pins[i], (command >> i) & 1);
+    }
+}
+
+void LCD_Display::write_byte(byte value, byte register_select) {
+    digitalWrite(_REGISTER_SELECT_PIN, register_select);   // LOW = Instruction register selected, HIGH = Data register selected
+    send_command(value);
+    pulse_enable();
+}
+
+LCD_Display *my_lcd_screen;
+unsigned long last_update_ms = 0;
+
+void setup() {
+    constexpr byte REGISTER_SELECT_PIN = D12;       // RW must be wired to ground for this lab
+    constexpr byte ENABLE_PIN = D10;
+    constexpr byte DATA_BUS[8] = {D9, D8, D7, D6, D5, D4, D3, D2};
+
+    Serial.begin(9600);
+
+    static LCD_Display lcd_screen(REGISTER_SELECT_PIN, ENABLE_PIN, DATA_BUS);   // static, so it outlives setup() and loop() can use it
+    my_lcd_screen = &lcd_screen;
+
+    // print_text() now only copies the string into the queue, the display catches up in the background
+    unsigned long started_us = micros();
+    my_lcd_screen->print_text("Hello World!!");
+    unsigned long queued_us = micros();
+    my_lcd_screen->flush();
+    unsigned long shown_us = micros();
+
+    Serial.print("print_text() returned after ");
+    Serial.print(queued_us - started_us);
+    Serial.print("us, the display caught up after ");
+    Serial.print(shown_us - started_us);
+    Serial.print("us, deepest the queue got was ");
+    Serial.println(my_lcd_screen->high_water_mark());
+
+    // From here on loop() never waits for the display. If the queue ever fills up we would rather lose an update than fall behind
+    my_lcd_screen->set_overflow_policy(LCD_Display::drop_output);
+}
+
+void loop() {
+    // Update the uptime ten times a second. An update that doesn't fit is dropped whole, and the next one puts the screen right
+    if (millis() - last_update_ms < 100) {
+        return;
+    }
+    last_update_ms = millis();
+
+    my_lcd_screen->set_cursor(0, 1);
+    my_lcd_screen->print_text("Uptime: " + String(last_update_ms / 100));
+}
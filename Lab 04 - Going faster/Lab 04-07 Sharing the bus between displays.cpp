@@ -0,0 +1,311 @@
+#include <Arduino.h>
+
+constexpr byte BUS_WIDTH = 8;
+constexpr byte QUEUE_SIZE = 32;         // bytes waiting to go out to each display, must be a power of two so the indexes can wrap with a mask
+
+constexpr unsigned long cycles_for_ns(unsigned long ns) {
+    return (ns * (F_CPU / 1000000UL) + 999) / 1000;
+}
+
+// digitalPinToPort() and digitalPinToBitMask() read tables out of flash, so the compiler can't see through them.
+// The Uno's pin mapping never changes though, so we can work it out ourselves and let the compiler do it once, at compile time.
+// D0-D7 are PORTD, D8-D13 are PORTB and A0-A5 are PORTC
+constexpr byte uno_port(byte pin) {
+    return pin < 8 ? PD : pin < 14 ? PB : PC;
+}
+
+constexpr byte uno_bit_mask(byte pin) {
+    return 1 << (pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14);
+}
+
+// The registers for each port. With PORT known at compile time each of these is just a fixed address,
+// and writing a single bit of one turns into a single sbi or cbi instruction
+template <byte PORT>
+inline auto &output_register(void) {
+    if constexpr (PORT == PB) return PORTB;
+    else if constexpr (PORT == PC) return PORTC;
+    else return PORTD;
+}
+
+template <byte PORT>
+inline auto &mode_register(void) {
+    if constexpr (PORT == PB) return DDRB;
+    else if constexpr (PORT == PC) return DDRC;
+    else return DDRD;
+}
+
+template <byte PIN>
+inline void write_pin(bool level) {
+    if (level) {
+        output_register<uno_port(PIN)>() |= uno_bit_mask(PIN);
+    }
+    else {
+        output_register<uno_port(PIN)>() &= (byte)~uno_bit_mask(PIN);
+    }
+}
+
+// The data bus, with every pin fixed at compile time. Every display hangs off the same eight wires, so we only write to it, never read
+template <byte DB0, byte DB1, byte DB2, byte DB3, byte DB4, byte DB5, byte DB6, byte DB7>
+class Uno_Bus {
+    public:
+        static void write(byte value) {
+            // The other pins on these ports belong to someone else, so nothing may change them between our read and our write
+            noInterrupts();
+            write_port<PB>(value);
+            write_port<PC>(value);
+            write_port<PD>(value);
+            interrupts();
+        }
+
+        // Drive the bus, setting every pin to output and LOW
+        static void take(void) {
+            noInterrupts();
+            take_port<PB>();
+            take_port<PC>();
+            take_port<PD>();
+            interrupts();
+        }
+
+    private:
+        constexpr static byte _PINS[BUS_WIDTH] = {DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7};
+
+        // Which bits of a port belong to the bus, worked out by the compiler
+        constexpr static byte port_mask(byte port) {
+            byte mask = 0;
+            for (byte i = 0; i < BUS_WIDTH; i++) {
+                if (uno_port(_PINS[i]) == port) mask |= uno_bit_mask(_PINS[i]);
+            }
+            return mask;
+        }
+
+        template <byte PORT>
+        static void write_port(byte value) {
+            constexpr byte MASK = port_mask(PORT);
+            if constexpr (MASK != 0) {              // ports the bus isn't on don't generate any code at all
+                byte levels = 0;
+                for (byte i = 0; i < BUS_WIDTH; i++) {  // every test and mask here is a constant, so this unrolls into a handful of bit moves
+                    if (uno_port(_PINS[i]) == PORT && (value & (1 << i))) levels |= uno_bit_mask(_PINS[i]);
+                }
+                output_register<PORT>() = (output_register<PORT>() & (byte)~MASK) | levels;
+            }
+        }
+
+        template <byte PORT>
+        static void take_port(void) {
+            constexpr byte MASK = port_mask(PORT);
+            if constexpr (MASK != 0) {
+                output_register<PORT>() &= (byte)~MASK;
+                mode_register<PORT>() |= MASK;
+            }
+        }
+};
+
+// Device timings from the datasheet. Execution times are for fosc = 270kHz (Table 6), bus timings are from Figure 25.
+// The enable pins have to be the last template parameter, so there is no room for a profile after them. For a controller that
+// runs slower, or a bus with long wires, change the Timing typedef in Shared_Bus_Displays
+struct HD44780_Timing {
+    constexpr static unsigned int CLEAR_US = 1520;             // clear display and return home
+    constexpr static unsigned int INSTRUCTION_US = 37;         // everything else
+    constexpr static unsigned int DATA_WRITE_US = 37 + 4;      // writing data takes 37us, then tADD of 4us before the address counter moves
+    constexpr static unsigned long ADDRESS_SETUP_NS = 40;      // tAS, RS and RW must settle before E rises
+    constexpr static unsigned long ENABLE_PULSE_NS = 230;      // PWEH, E must stay HIGH this long
+    constexpr static unsigned long DATA_HOLD_NS = 10;          // tH, the bus must not change straight after E falls
+};
+
+// Several displays sharing RS and the data bus, each with its own E line. A display only listens to the bus while its own E is HIGH,
+// so while one of them is busy for 37us working on the last byte, there is plenty of time to hand bytes to all the others.
+// Every display gets its own queue, and service() goes round them in turn, sending to whichever ones are ready.
+// RW must be tied to ground on every display, the busy flag can't be read from several displays through one pin
+template <byte RS, byte DB0, byte DB1, byte DB2, byte DB3, byte DB4, byte DB5, byte DB6, byte DB7, byte... ENABLE_PINS>
+class Shared_Bus_Displays {
+    public:
+        constexpr static byte DISPLAY_COUNT = sizeof...(ENABLE_PINS);
+
+        Shared_Bus_Displays(void) {
+            // Initialise the device control pins
+            pinMode(RS, OUTPUT);
+            (pinMode(ENABLE_PINS, OUTPUT), ...);
+            (digitalWrite(ENABLE_PINS, LOW), ...);  // E idles LOW, a display latches whatever is on the bus when its E falls
+
+            // Initialise the data bus, setting the pins to output and LOW by default
+            Bus::take();
+
+            // Initialise every display. These all go out together, so the 1.52ms clear only has to be waited out once
+            for (byte display = 0; display < DISPLAY_COUNT; display++) {
+                enqueue(display, instr_fn_set, LOW);
+                enqueue(display, instr_display_on_no_cursor_blink, LOW);
+                enqueue(display, instr_entry_mode, LOW);
+                enqueue(display, instr_clear_disp, LOW);    // Clear the display (This also resets cursor position)
+            }
+            flush();
+        }
+
+        void print_text(byte display, const String text) {
+            for (byte i = 0; i < text.length(); i++) {
+                enqueue(display, text[i], HIGH);
+            }
+        }
+
+        void set_cursor(byte display, byte column, byte row) {
+            constexpr byte ROW_ADDRESS[2] = {0x00, 0x40};
+            enqueue(display, instr_set_ddram_addr | (ROW_ADDRESS[row & 1] + column), LOW);
+        }
+
+        byte queue_depth(byte display) {
+            return (byte)(_queues[display].head - _queues[display].tail) & (QUEUE_SIZE - 1);
+        }
+
+        // Send one byte to every display that has something queued and has finished the last thing we sent it.
+        // Call this as often as you can, each call only takes as long as the bytes it sends
+        void service(void) {
+            for (byte display = 0; display < DISPLAY_COUNT; display++) {
+                Display_Queue &queue = _queues[display];
+                if (queue.head == queue.tail) {
+                    continue;
+                }
+
+                // Read the clock for each display, so the time we note below is never earlier than its E actually fell
+                unsigned long now_us = micros();
+                if ((long)(now_us - queue.ready_at_us) < 0) {
+                    continue;
+                }
+
+                byte value = queue.values[queue.tail];
+                byte register_select = queue.register_selects[queue.tail];
+                queue.tail = (queue.tail + 1) & (QUEUE_SIZE - 1);
+
+                write_pin<RS>(register_select);     // LOW = Instruction register selected, HIGH = Data register selected
+                Bus::write(value);
+                pulse_enable(display);
+
+                // E fell within one micros() step of now_us, plus the pulse itself
+                queue.ready_at_us = now_us + _MICROS_RESOLUTION_US + _PULSE_TIME_US + (register_select ? Timing::DATA_WRITE_US : execution_time_us(value));
+            }
+        }
+
+        // Keep servicing until every queue is empty and every display has finished
+        void flush(void) {
+            for (byte display = 0; display < DISPLAY_COUNT; display++) {
+                while (queue_depth(display) > 0) {
+                    service();
+                }
+            }
+            for (byte display = 0; display < DISPLAY_COUNT; display++) {
+                while ((long)(micros() - _queues[display].ready_at_us) < 0) {
+                    // the last byte is still being executed
+                }
+            }
+        }
+
+        typedef Uno_Bus<DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7> Bus;
+        typedef HD44780_Timing Timing;      // shared by every display on the bus, so it has to suit the slowest of them
+
+    private:
+        static_assert(DISPLAY_COUNT >= 1 && DISPLAY_COUNT <= 8, "give each display its own enable pin, up to 8 of them");
+        static_assert(RS < 20 && ((ENABLE_PINS < 20) && ...), "control pins must be D0-D13 or A0-A5");
+        static_assert(DB0 < 20 && DB1 < 20 && DB2 < 20 && DB3 < 20 && DB4 < 20 && DB5 < 20 && DB6 < 20 && DB7 < 20, "data pins must be D0-D13 or A0-A5");
+
+        constexpr static unsigned long _MICROS_RESOLUTION_US = 64000000UL / F_CPU;    // micros() counts in steps of 4us at 16MHz, so we allow for one extra step
+        constexpr static unsigned long _PULSE_TIME_US = 1;     // pulse_enable() takes well under 1us from start to the falling edge
+
+        struct Display_Queue {
+            byte values[QUEUE_SIZE];
+            byte register_selects[QUEUE_SIZE];
+            byte head = 0;                  // where the next byte goes in
+            byte tail = 0;                  // where service() takes the next byte out
+            unsigned long ready_at_us = 0;  // when the display will have finished the last thing we sent it
+        };
+
+        Display_Queue _queues[DISPLAY_COUNT];
+
+        enum LCD_Instructions: byte {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+            instr_set_ddram_addr                = 0b10000000, // 0x80 Set DDRAM address, OR the address into the low 7 bits
+        };
+
+        static unsigned int execution_time_us(byte instruction) {
+            return instruction <= instr_return_home ? Timing::CLEAR_US : Timing::INSTRUCTION_US;
+        }
+
+        void enqueue(byte display, byte value, byte register_select) {
+            Display_Queue &queue = _queues[display];
+            while (queue_depth(display) == QUEUE_SIZE - 1) {   // one slot is always left empty, otherwise a full queue would look the same as an empty one
+                service();                                  // back pressure, the other displays keep going while we wait for room
+            }
+            queue.values[queue.head] = value;
+            queue.register_selects[queue.head] = register_select;
+            queue.head = (queue.head + 1) & (QUEUE_SIZE - 1);
+        }
+
+        template <byte E>
+        static void pulse_enable(void) {
+            // E is a constant pin on a constant port, so each edge is one sbi or cbi
+            __builtin_avr_delay_cycles(cycles_for_ns(Timing::ADDRESS_SETUP_NS));
+            write_pin<E>(HIGH);
+            __builtin_avr_delay_cycles(cycles_for_ns(Timing::ENABLE_PULSE_NS));
+            write_pin<E>(LOW);                      // the falling edge is what latches the command
+            __builtin_avr_delay_cycles(cycles_for_ns(Timing::DATA_HOLD_NS));
+        }
+
+        // Picks the enable pin for a display number. The compiler turns this into a chain of compares, each with its own fixed sbi and cbi
+        static void pulse_enable(byte display) {
+            byte index = 0;
+            ((display == index++ ? pulse_enable<ENABLE_PINS>() : void()), ...);
+        }
+};
+
+// RS = D12, DB0-DB7 = D9, D8, D7, D6, D5, D4, D3, D2, and the four displays have their enables on D10, D13, A0 and A1
+typedef Shared_Bus_Displays<D12, D9, D8, D7, D6, D5, D4, D3, D2, D10, D13, A0, A1> My_LCD_Displays;
+
+My_LCD_Displays *my_lcd_screens;
+
+void setup() {
+    Serial.begin(9600);
+
+    static My_LCD_Displays lcd_screens;     // static, so it outlives setup() and loop() can use it
+    my_lcd_screens = &lcd_screens;
+
+    // Fill both rows of the first display, then the first two, and so on, timing how many characters per second get through in total
+    constexpr byte PASSES = 8;
+    unsigned long one_display_us = 0;
+    for (byte displays = 1; displays <= My_LCD_Displays::DISPLAY_COUNT; displays++) {
+        unsigned long started_us = micros();
+        for (byte pass = 0; pass < PASSES; pass++) {
+            for (byte display = 0; display < displays; display++) {
+                my_lcd_screens->set_cursor(display, 0, pass & 1);
+                my_lcd_screens->print_text(display, "Sharing the bus!");
+            }
+            my_lcd_screens->service();
+        }
+        my_lcd_screens->flush();
+        unsigned long elapsed_us = micros() - started_us;
+        if (displays == 1) {
+            one_display_us = elapsed_us;
+        }
+
+        unsigned long characters = (unsigned long)PASSES * 16 * displays;
+        Serial.print(displays);
+        Serial.print(displays == 1 ? " display:  " : " displays: ");
+        Serial.print(characters * 1000000UL / elapsed_us);
+        Serial.print(" characters per second, ");
+        Serial.print((double)one_display_us * displays / elapsed_us);
+        Serial.println("x one display");
+    }
+
+    for (byte display = 0; display < My_LCD_Displays::DISPLAY_COUNT; display++) {
+        my_lcd_screens->set_cursor(display, 0, 0);
+        my_lcd_screens->print_text(display, "Display " + String(display + 1) + "       ");
+        my_lcd_screens->set_cursor(display, 0, 1);
+        my_lcd_screens->print_text(display, "Hello World!!   ");
+    }
+    my_lcd_screens->flush();
+}
+
+void loop() {
+    // Nothing is queued any more, but this is where service() goes if there is, so the displays keep up without anything waiting on them
+    my_lcd_screens->service();
+}
@@ -0,0 +1,482 @@
+#include <Arduino.h>
+
+constexpr byte BUS_WIDTH = 8;
+constexpr byte NOT_CONNECTED = 0xFF;    // pass this in as the read/write pin on boards where RW is tied to ground
+
+typedef decltype(portOutputRegister(0)) port_register_pointer;     // volatile uint8_t * on AVR
+
+constexpr unsigned long cycles_for_ns(unsigned long ns) {
+    return (ns * (F_CPU / 1000000UL) + 999) / 1000;
+}
+
+// The data bus, written a whole port at a time. digitalWrite() looks up the port and bit for its pin every single call, then does a
+// read-modify-write on that port, so eight of them per byte is eight lookups and eight writes. Here the lookups happen once in begin(),
+// and each byte becomes one masked write to each port the bus is wired to.
+class Fast_Bus {
+    public:
+        void begin(const byte pins[]);
+        void write(byte value);
+        byte read(void);
+        void release(void);     // let the display drive the bus, DB7 gets a pull up so nothing answering reads as busy
+        void take(void);        // drive the bus ourselves again
+
+    private:
+        constexpr static byte _MAX_PORTS = 3;   // an 8 bit bus can land on at most three ports on an Uno (B, C and D)
+
+        struct Bus_Port {
+            port_register_pointer output;       // PORTx
+            port_register_pointer input;        // PINx
+            port_register_pointer mode;         // DDRx
+            byte mask;                          // which bits of this port belong to the bus
+        };
+
+        Bus_Port _ports[_MAX_PORTS];
+        byte _port_count = 0;
+        byte _port_of_bit[BUS_WIDTH];           // for each bus bit, which of _ports it is on
+        byte _mask_of_bit[BUS_WIDTH];           // and where on that port
+};
+
+void Fast_Bus::begin(const byte pins[]) {
+    _port_count = 0;
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        byte port = digitalPinToPort(pins[i]);
+        port_register_pointer output = portOutputRegister(port);
+
+        byte entry = 0;
+        while (entry < _port_count && _ports[entry].output != output) {
+            entry++;
+        }
+        if (entry == _port_count) {
+            _ports[_port_count++] = {output, portInputRegister(port), portModeRegister(port), 0};
+        }
+
+        _port_of_bit[i] = entry;
+        _mask_of_bit[i] = digitalPinToBitMask(pins[i]);
+        _ports[entry].mask |= _mask_of_bit[i];
+    }
+    take();
+}
+
+void Fast_Bus::write(byte value) {
+    // Shuffle the bits into place for each port first, so the ports themselves are only touched once each
+    byte levels[_MAX_PORTS] = {0, 0, 0};
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        if (value & (1 << i)) {
+            levels[_port_of_bit[i]] |= _mask_of_bit[i];
+        }
+    }
+
+    // The other pins on these ports belong to someone else, so nothing may change them between our read and our write
+    noInterrupts();
+    for (byte p = 0; p < _port_count; p++) {
+        *_ports[p].output = (*_ports[p].output & ~_ports[p].mask) | levels[p];
+    }
+    interrupts();
+}
+
+byte Fast_Bus::read(void) {
+    byte levels[_MAX_PORTS];
+    for (byte p = 0; p < _port_count; p++) {
+        levels[p] = *_ports[p].input;
+    }
+
+    byte value = 0;
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        if (levels[_port_of_bit[i]] & _mask_of_bit[i]) {
+            value |= 1 << i;
+        }
+    }
+    return value;
+}
+
+void Fast_Bus::release(void) {
+    noInterrupts();
+    for (byte p = 0; p < _port_count; p++) {
+        *_ports[p].mode &= ~_ports[p].mask;
+        *_ports[p].output &= ~_ports[p].mask;   // on an input pin PORTx turns the pull up on or off
+    }
+    *_ports[_port_of_bit[BUS_WIDTH - 1]].output |= _mask_of_bit[BUS_WIDTH - 1];
+    interrupts();
+}
+
+void Fast_Bus::take(void) {
+    noInterrupts();
+    for (byte p = 0; p < _port_count; p++) {
+        *_ports[p].output &= ~_ports[p].mask;   // drop the pull up before the pin starts driving, so DB7 doesn't come up HIGH
+        *_ports[p].mode |= _ports[p].mask;
+    }
+    interrupts();
+}
+
+class LCD_Display {
+    public:
+        LCD_Display(byte register_select_pin, byte read_write_pin, byte enable_pin, const byte data_bus_pins[]);
+        void set_cursor(byte column, byte row);
+
+        // Text. None of these touch the heap, the characters go straight from wherever they are to the display
+        void print_text(const char *text);                          // a normal C string
+        void print_text(const char *text, byte length);             // part of a string, or a buffer that isn't NUL terminated
+        void print_text(const __FlashStringHelper *text);           // print_text(F("Hello")) keeps the text in flash, saving RAM too
+        void print_text_P(PGM_P text);                              // a string declared PROGMEM
+        void print_text(const String &text);                        // still here for sketches that already have a String, but by reference so it isn't copied
+        void print_char(char character);
+
+        // Numbers, worked out into a small buffer on the stack and sent from there
+        void print_number(long value, byte base = DEC);
+        void print_number(unsigned long value, byte base = DEC);
+        void print_number(int value, byte base = DEC) { print_number((long)value, base); }
+        void print_number(unsigned int value, byte base = DEC) { print_number((unsigned long)value, base); }
+        void print_fixed(long value, byte decimals);                // print_fixed(2154, 2) shows 21.54, no floating point needed
+        void print_float(double value, byte decimals = 2);
+
+        bool busy_flag_mode(void) { return _busy_flag_mode; }   // false if we are timing every instruction instead
+
+    private:
+        // Device control pins
+        const byte _REGISTER_SELECT_PIN;
+        const byte _READ_WRITE_PIN;
+        const byte _ENABLE_PIN;
+
+        // The enable strobe has to be timed to within a few hundred nanoseconds, far quicker than digitalWrite(), so we write its port directly
+        port_register_pointer _enable_port;
+        const byte _enable_mask;
+
+        // Device data bus
+        static Fast_Bus _data_bus;     // declared static because other devices can share the same data bus, no need to have separate data busses for multiple devices.
+
+        // Device timings. Execution times from the datasheet (Table 6, fosc = 270kHz), indexed by the highest bit set in the instruction
+        constexpr static unsigned int _EXECUTION_TIME_US[8] = {
+            1520,   // 0b00000001 clear display
+            1520,   // 0b0000001x return home
+            37,     // 0b000001xx entry mode set
+            37,     // 0b00001xxx display on/off control
+            37,     // 0b0001xxxx cursor or display shift
+            37,     // 0b001xxxxx function set
+            37,     // 0b01xxxxxx set CGRAM address
+            37,     // 0b1xxxxxxx set DDRAM address
+        };
+        constexpr static unsigned int _DATA_WRITE_TIME_US = 37 + 4;    // writing data takes 37us, then tADD of 4us before the address counter moves
+        constexpr static unsigned long _MICROS_RESOLUTION_US = 64000000UL / F_CPU;    // micros() counts in steps of 4us at 16MHz, so we allow for one extra step
+        constexpr static unsigned long _PULSE_TIME_US = 1;     // pulse_enable() takes well under 1us from start to the falling edge
+        constexpr static unsigned long _BUSY_TIMEOUT_US = 3000; // nothing takes longer than 1.53ms (2.16ms on a slow oscillator), so if we are still busy after this, nobody is answering
+
+        // Bus timings from the datasheet (Figure 25), converted to CPU cycles and rounded up
+        constexpr static unsigned long _ADDRESS_SETUP_CYCLES = cycles_for_ns(40);     // tAS, RS and RW must settle before E rises
+        constexpr static unsigned long _ENABLE_PULSE_CYCLES = cycles_for_ns(230);     // PWEH, E must stay HIGH this long. Also covers tDDR (160ns) on a read
+        constexpr static unsigned long _DATA_HOLD_CYCLES = cycles_for_ns(10);         // tH, the bus must not change straight after E falls
+
+        bool _busy_flag_mode;   // true = poll the busy flag before every write, false = time every write from the table above
+        unsigned long _ready_at_us = 0;     // when the display will have finished the last thing we sent it, in timed mode
+
+        enum LCD_Instructions: byte {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+            instr_set_ddram_addr                = 0b10000000, // 0x80 Set DDRAM address, OR the address into the lower 7 bits
+        };
+
+        void print_digits(unsigned long value, byte base, byte minimum_digits);
+
+        static unsigned int execution_time_us(byte instruction);
+        void pulse_enable(void);
+        void write_byte(byte value, byte register_select);
+        void wait_until_ready(void);
+        bool read_busy_flag(void);
+};
+
+Fast_Bus LCD_Display::_data_bus;
+
+LCD_Display::LCD_Display(byte register_select_pin, byte read_write_pin, byte enable_pin, const byte data_bus_pins[])
+    :  _REGISTER_SELECT_PIN(register_select_pin), _READ_WRITE_PIN(read_write_pin), _ENABLE_PIN(enable_pin),
+       _enable_port(portOutputRegister(digitalPinToPort(enable_pin))), _enable_mask(digitalPinToBitMask(enable_pin)),
+       _busy_flag_mode(read_write_pin != NOT_CONNECTED)
+{
+    // Initialise the device control pins
+    pinMode(_REGISTER_SELECT_PIN, OUTPUT);
+    pinMode(_ENABLE_PIN, OUTPUT);
+    digitalWrite(_ENABLE_PIN, LOW);                 // E idles LOW, the display latches whatever is on the bus when it falls
+
+    if (_busy_flag_mode) {
+        pinMode(_READ_WRITE_PIN, OUTPUT);
+        digitalWrite(_READ_WRITE_PIN, LOW);         // LOW = Write mode, HIGH = Read Mode
+    }
+
+    // Initialise the data bus, working out which ports it is on, setting the pins to output and LOW by default
+    _data_bus.begin(data_bus_pins);
+
+    // Initialise the display. Each write waits for the one before it, so there is no need to sleep after the clear any more
+    write_byte(instr_fn_set, LOW);
+    write_byte(instr_display_on_no_cursor_blink, LOW);
+    write_byte(instr_entry_mode, LOW);
+    write_byte(instr_clear_disp, LOW);              // Clear the display (This also resets cursor position)
+}
+
+void LCD_Display::set_cursor(byte column, byte row) {
+    constexpr byte ROW_ADDRESS[2] = {0x00, 0x40};
+    write_byte(instr_set_ddram_addr | (ROW_ADDRESS[row & 1] + column), LOW);
+}
+
+void LCD_Display::print_text(const char *text) {
+    while (*text) {
+        write_byte(*text++, HIGH);
+    }
+}
+
+void LCD_Display::print_text(const char *text, byte length) {
+    for (byte i = 0; i < length; i++) {
+        write_byte(text[i], HIGH);
+    }
+}
+
+void LCD_Display::print_text(const __FlashStringHelper *text) {
+    print_text_P(reinterpret_cast<PGM_P>(text));
+}
+
+void LCD_Display::print_text_P(PGM_P text) {
+    // On AVR flash is a separate address space, so each character has to be fetched with pgm_read_byte() rather than through the pointer
+    char character;
+    while ((character = pgm_read_byte(text++)) != '\0') {
+        write_byte(character, HIGH);
+    }
+}
+
+void LCD_Display::print_text(const String &text) {
+    print_text(text.c_str(), text.length());
+}
+
+void LCD_Display::print_char(char character) {
+    write_byte(character, HIGH);
+}
+
+void LCD_Display::print_number(long value, byte base) {
+    if (value < 0 && base == DEC) {
+        print_char('-');
+        print_digits(0UL - (unsigned long)value, base, 1);     // done unsigned, so the most negative long still works
+        return;
+    }
+    print_digits(value, base, 1);
+}
+
+void LCD_Display::print_number(unsigned long value, byte base) {
+    print_digits(value, base, 1);
+}
+
+void LCD_Display::print_fixed(long value, byte decimals) {
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : value;
+    unsigned long scale = 1;
+    for (byte i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+
+    if (value < 0) {
+        print_char('-');
+    }
+    print_digits(magnitude / scale, DEC, 1);
+    if (decimals > 0) {
+        print_char('.');
+        print_digits(magnitude % scale, DEC, decimals);    // keep the leading zeros, 5 with 2 decimals is .05
+    }
+}
+
+void LCD_Display::print_float(double value, byte decimals) {
+    // The same rules as Arduino's Print::printFloat(), without going through a String
+    if (isnan(value)) {
+        print_text("nan");
+        return;
+    }
+    if (isinf(value)) {
+        print_text("inf");
+        return;
+    }
+    if (value > 4294967040.0 || value < -4294967040.0) {
+        print_text("ovf");                          // the whole number part has to fit in an unsigned long
+        return;
+    }
+
+    if (value < 0.0) {
+        print_char('-');
+        value = -value;
+    }
+
+    // Round to the number of decimals we are showing, so 1.999 with 2 decimals is 2.00 rather than 1.99
+    double rounding = 0.5;
+    for (byte i = 0; i < decimals; i++) {
+        rounding /= 10.0;
+    }
+    value += rounding;
+
+    unsigned long whole = (unsigned long)value;
+    print_digits(whole, DEC, 1);
+    if (decimals > 0) {
+        print_char('.');
+        double remainder = value - (double)whole;
+        for (byte i = 0; i < decimals; i++) {
+            remainder *= 10.0;
+            byte digit = (byte)remainder;
+            print_char('0' + digit);
+            remainder -= digit;
+        }
+    }
+}
+
+void LCD_Display::print_digits(unsigned long value, byte base, byte minimum_digits) {
+    // Digits come out least significant first, so they go into the buffer backwards and are sent from there
+    char buffer[8 * sizeof(unsigned long)];         // enough for an unsigned long in binary
+    byte digits = 0;
+    if (base < 2) {
+        base = DEC;
+    }
+
+    do {
+        byte digit = value % base;
+        buffer[digits++] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        value /= base;
+    } while (value > 0 && digits < sizeof(buffer));
+
+    while (digits < minimum_digits && digits < sizeof(buffer)) {
+        buffer[digits++] = '0';
+    }
+
+    while (digits > 0) {
+        write_byte(buffer[--digits], HIGH);
+    }
+}
+
+unsigned int LCD_Display::execution_time_us(byte instruction) {
+    byte highest_bit = 7;
+    while (highest_bit > 0 && !(instruction & (1 << highest_bit))) {
+        highest_bit--;
+    }
+    return _EXECUTION_TIME_US[highest_bit];
+}
+
+void LCD_Display::pulse_enable(void) {
+    // E shares its port with other pins, so nothing may touch that port between our read and write. This also keeps the pulse exactly as long as we asked
+    noInterrupts();
+    __builtin_avr_delay_cycles(_ADDRESS_SETUP_CYCLES);
+    *_enable_port |= _enable_mask;
+    __builtin_avr_delay_cycles(_ENABLE_PULSE_CYCLES);
+    *_enable_port &= ~_enable_mask;                 // the falling edge is what latches the command
+    __builtin_avr_delay_cycles(_DATA_HOLD_CYCLES);
+    interrupts();
+}
+
+void LCD_Display::write_byte(byte value, byte register_select) {
+    if (_busy_flag_mode) {
+        wait_until_ready();
+    }
+
+    digitalWrite(_REGISTER_SELECT_PIN, register_select);   // LOW = Instruction register selected, HIGH = Data register selected
+    _data_bus.write(value);
+
+    if (_busy_flag_mode) {
+        pulse_enable();
+        return;
+    }
+
+    // The display has been executing the last command while we set up this one, so we only wait for whatever time is left
+    unsigned long now_us;
+    do {
+        now_us = micros();
+    } while ((long)(now_us - _ready_at_us) < 0);
+
+    pulse_enable();
+
+    // Rather than sleeping now, note when the display will be done and let the caller get on with something else.
+    // E fell within one micros() step of now_us, plus the pulse itself
+    _ready_at_us = now_us + _MICROS_RESOLUTION_US + _PULSE_TIME_US + (register_select ? _DATA_WRITE_TIME_US : execution_time_us(value));
+}
+
+void LCD_Display::wait_until_ready(void) {
+    // Hand the data bus over to the display. DB7 gets a pull up, so if nothing is driving it we read busy and eventually time out
+    _data_bus.release();
+    digitalWrite(_REGISTER_SELECT_PIN, LOW);        // the busy flag is read from the instruction register
+    digitalWrite(_READ_WRITE_PIN, HIGH);            // LOW = Write mode, HIGH = Read Mode
+
+    unsigned long started_us = micros();
+    while (read_busy_flag()) {
+        if (micros() - started_us > _BUSY_TIMEOUT_US) {
+            // RW is probably tied to ground, and every poll has just strobed whatever was floating on the bus into the display.
+            // Fall back to timed mode for good, and give that junk instruction as long as the slowest one takes to finish.
+            _busy_flag_mode = false;
+            _ready_at_us = micros() + _MICROS_RESOLUTION_US + _EXECUTION_TIME_US[0];
+            break;
+        }
+    }
+
+    // Take the data bus back. E is already LOW, so the display has let go of it
+    digitalWrite(_READ_WRITE_PIN, LOW);
+    _data_bus.take();
+}
+
+bool LCD_Display::read_busy_flag(void) {
+    noInterrupts();
+    __builtin_avr_delay_cycles(_ADDRESS_SETUP_CYCLES);
+    *_enable_port |= _enable_mask;                  // the display drives the bus for as long as E is HIGH
+    __builtin_avr_delay_cycles(_ENABLE_PULSE_CYCLES);
+    interrupts();
+    bool busy = _data_bus.read() & 0x80;            // DB7 is the busy flag, DB0-DB6 hold the address counter
+    noInterrupts();
+    *_enable_port &= ~_enable_mask;
+    interrupts();
+    return busy;
+}
+
+LCD_Display *my_lcd_screen;
+unsigned long last_update_ms = 0;
+
+void setup() {
+    constexpr byte REGISTER_SELECT_PIN = D12;
+    constexpr byte READ_WRITE_PIN = NOT_CONNECTED;  // timed mode. Use D11 here to poll the busy flag instead, RW must be held LOW if it is wired up but not used
+    constexpr byte ENABLE_PIN = D10;
+    constexpr byte DATA_BUS[8] = {D9, D8, D7, D6, D5, D4, D3, D2};
+
+    Serial.begin(9600);
+
+    static LCD_Display lcd_screen(REGISTER_SELECT_PIN, READ_WRITE_PIN, ENABLE_PIN, DATA_BUS);   // static, so it outlives setup() and loop() can use it
+    my_lcd_screen = &lcd_screen;
+    my_lcd_screen->print_text(F("Hello World!!"));
+}
+
+void loop() {
+    if (millis() - last_update_ms < 20) {
+        return;
+    }
+    last_update_ms = millis();
+    unsigned long uptime_tenths = last_update_ms / 100;
+
+    // The old way, building the line up as a String. Every piece is a new buffer on the heap, and the + copies them all again.
+    // Only the simulator can count the allocations, see simulated_heap_allocations, so on the board this just prints
+#ifdef HOST_SIMULATOR
+    unsigned long allocations = simulated_heap_allocations;
+#endif
+    my_lcd_screen->set_cursor(0, 0);
+    my_lcd_screen->print_text("Up " + String(uptime_tenths / 10) + "." + String(uptime_tenths % 10) + "s       ");
+#ifdef HOST_SIMULATOR
+    unsigned long string_allocations = simulated_heap_allocations - allocations;
+    allocations = simulated_heap_allocations;
+#endif
+
+    // The same thing and a bit more, straight to the display
+    my_lcd_screen->set_cursor(0, 1);
+    my_lcd_screen->print_fixed(uptime_tenths, 1);
+    my_lcd_screen->print_char('s');
+    my_lcd_screen->print_text(" ", 1);
+    my_lcd_screen->print_float(-12.5 + last_update_ms / 1000.0, 1);
+    my_lcd_screen->print_text(F(" 0x"));
+    my_lcd_screen->print_number(last_update_ms & 0xFF, HEX);
+    my_lcd_screen->print_text("    ", 4);          // the shortest this row gets is 12 characters, so this covers whatever a longer one left behind
+
+#ifdef HOST_SIMULATOR
+    unsigned long print_allocations = simulated_heap_allocations - allocations;
+    Serial.print(F("String: "));
+    Serial.print(string_allocations);
+    Serial.print(F(" heap allocations, print_fixed(), print_float() and friends: "));
+    Serial.println(print_allocations);
+    if (print_allocations != 0) {
+        simulated_board.fail("print_fixed(), print_float() and friends used the heap");
+    }
+#endif
+}
@@ -0,0 +1,482 @@
+#include <Arduino.h>
+
+constexpr byte BUS_WIDTH = 8;
+constexpr byte NOT_CONNECTED = 0xFF;    // pass this in as the read/write pin on boards where RW is tied to ground
+
+constexpr unsigned long cycles_for_ns(unsigned long ns) {
+    return (ns * (F_CPU / 1000000UL) + 999) / 1000;
+}
+
+// digitalPinToPort() and digitalPinToBitMask() read tables out of flash, so the compiler can't see through them.
+// The Uno's pin mapping never changes though, so we can work it out ourselves and let the compiler do it once, at compile time.
+// D0-D7 are PORTD, D8-D13 are PORTB and A0-A5 are PORTC
+constexpr byte uno_port(byte pin) {
+    return pin < 8 ? PD : pin < 14 ? PB : PC;
+}
+
+constexpr byte uno_bit_mask(byte pin) {
+    return 1 << (pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14);
+}
+
+// The registers for each port. With PORT known at compile time each of these is just a fixed address,
+// and writing a single bit of one turns into a single sbi or cbi instruction
+template <byte PORT>
+inline auto &output_register(void) {
+    if constexpr (PORT == PB) return PORTB;
+    else if constexpr (PORT == PC) return PORTC;
+    else return PORTD;
+}
+
+template <byte PORT>
+inline auto &input_register(void) {
+    if constexpr (PORT == PB) return PINB;
+    else if constexpr (PORT == PC) return PINC;
+    else return PIND;
+}
+
+template <byte PORT>
+inline auto &mode_register(void) {
+    if constexpr (PORT == PB) return DDRB;
+    else if constexpr (PORT == PC) return DDRC;
+    else return DDRD;
+}
+
+template <byte PIN>
+inline void write_pin(bool level) {
+    if (level) {
+        output_register<uno_port(PIN)>() |= uno_bit_mask(PIN);
+    }
+    else {
+        output_register<uno_port(PIN)>() &= (byte)~uno_bit_mask(PIN);
+    }
+}
+
+// The data bus, with every pin fixed at compile time. There is nothing to store, so everything here is static
+template <byte DB0, byte DB1, byte DB2, byte DB3, byte DB4, byte DB5, byte DB6, byte DB7>
+class Uno_Bus {
+    public:
+        static void write(byte value) {
+            // The other pins on these ports belong to someone else, so nothing may change them between our read and our write
+            noInterrupts();
+            write_port<PB>(value);
+            write_port<PC>(value);
+            write_port<PD>(value);
+            interrupts();
+        }
+
+        static byte read(void) {
+            return read_port<PB>() | read_port<PC>() | read_port<PD>();
+        }
+
+        // Let the display drive the bus, DB7 gets a pull up so nothing answering reads as busy
+        static void release(void) {
+            noInterrupts();
+            set_direction<PB>(false);
+            set_direction<PC>(false);
+            set_direction<PD>(false);
+            write_pin<DB7>(HIGH);                    // on an input pin PORTx turns the pull up on
+            interrupts();
+        }
+
+        // Drive the bus ourselves again
+        static void take(void) {
+            noInterrupts();
+            set_direction<PB>(true);
+            set_direction<PC>(true);
+            set_direction<PD>(true);
+            interrupts();
+        }
+
+    private:
+        constexpr static byte _PINS[BUS_WIDTH] = {DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7};
+
+        // Which bits of a port belong to the bus, worked out by the compiler
+        constexpr static byte port_mask(byte port) {
+            byte mask = 0;
+            for (byte i = 0; i < BUS_WIDTH; i++) {
+                if (uno_port(_PINS[i]) == port) mask |= uno_bit_mask(_PINS[i]);
+            }
+            return mask;
+        }
+
+        template <byte PORT>
+        static void write_port(byte value) {
+            constexpr byte MASK = port_mask(PORT);
+            if constexpr (MASK != 0) {              // ports the bus isn't on don't generate any code at all
+                byte levels = 0;
+                for (byte i = 0; i < BUS_WIDTH; i++) {  // every test and mask here is a constant, so this unrolls into a handful of bit moves
+                    if (uno_port(_PINS[i]) == PORT && (value & (1 << i))) levels |= uno_bit_mask(_PINS[i]);
+                }
+                output_register<PORT>() = (output_register<PORT>() & (byte)~MASK) | levels;
+            }
+        }
+
+        template <byte PORT>
+        static byte read_port(void) {
+            constexpr byte MASK = port_mask(PORT);
+            byte value = 0;
+            if constexpr (MASK != 0) {
+                byte levels = input_register<PORT>();
+                for (byte i = 0; i < BUS_WIDTH; i++) {
+                    if (uno_port(_PINS[i]) == PORT && (levels & uno_bit_mask(_PINS[i]))) value |= 1 << i;
+                }
+            }
+            return value;
+        }
+
+        template <byte PORT>
+        static void set_direction(bool output) {
+            constexpr byte MASK = port_mask(PORT);
+            if constexpr (MASK != 0) {
+                output_register<PORT>() &= (byte)~MASK;   // drop any pull ups first, so DB7 doesn't come up HIGH when it starts driving
+                if (output) {
+                    mode_register<PORT>() |= MASK;
+                }
+                else {
+                    mode_register<PORT>() &= (byte)~MASK;
+                }
+            }
+        }
+};
+
+// Device timings from the datasheet. Execution times are for fosc = 270kHz (Table 6), bus timings are from Figure 25.
+// Pass a different profile in as the last template parameter for a controller that runs slower, or a bus with long wires
+struct HD44780_Timing {
+    constexpr static unsigned int CLEAR_US = 1520;             // clear display and return home
+    constexpr static unsigned int INSTRUCTION_US = 37;         // everything else
+    constexpr static unsigned int DATA_WRITE_US = 37 + 4;      // writing data takes 37us, then tADD of 4us before the address counter moves
+    constexpr static unsigned long ADDRESS_SETUP_NS = 40;      // tAS, RS and RW must settle before E rises
+    constexpr static unsigned long ENABLE_PULSE_NS = 230;      // PWEH, E must stay HIGH this long. Also covers tDDR (160ns) on a read
+    constexpr static unsigned long DATA_HOLD_NS = 10;          // tH, the bus must not change straight after E falls
+};
+
+// A controller on the slow end of its oscillator range (fosc = 190kHz) takes 270/190 times as long over everything
+struct HD44780_Slow_Timing: HD44780_Timing {
+    constexpr static unsigned int CLEAR_US = 2160;
+    constexpr static unsigned int INSTRUCTION_US = 53;
+    constexpr static unsigned int DATA_WRITE_US = 53 + 6;
+};
+
+// Instrumentation is picked with another template parameter. LCD_Display calls these hooks from its hot path, and inherits from
+// whichever one it is given, so this one costs nothing at all: every hook is an empty inline function the compiler throws away,
+// and with no members it doesn't even take up a byte of the display (the empty base class optimisation)
+struct No_Instrumentation {
+    void call_started(void) {}
+    void display_ready(void) {}
+    void byte_sent(byte, byte) {}
+    void busy_flag_read(byte) {}
+    void enable_pulsed(void) {}
+    void call_finished(void) {}
+};
+
+// The last few bus transactions and when they happened, kept in a ring so the newest always replaces the oldest
+enum Bus_Transaction_Kind: byte {
+    instruction_write,
+    data_write,
+    status_read,                            // the busy flag and address counter
+};
+
+struct Bus_Transaction {
+    unsigned long at_us;
+    byte value;
+    Bus_Transaction_Kind kind;
+};
+
+template <byte DEPTH>
+class Bus_Trace {
+    public:
+        void record(byte value, Bus_Transaction_Kind kind) {
+            _ring[_next] = {micros(), value, kind};
+            _next = (_next + 1) % DEPTH;
+            if (_length < DEPTH) {
+                _length++;
+            }
+        }
+
+        byte length(void) const { return _length; }
+
+        // Oldest first
+        const Bus_Transaction &operator[](byte index) const {
+            return _ring[(_next + DEPTH - _length + index) % DEPTH];
+        }
+
+    private:
+        Bus_Transaction _ring[DEPTH];
+        byte _next = 0, _length = 0;
+};
+
+// No trace at all, recording into it does nothing
+template <>
+class Bus_Trace<0> {
+    public:
+        void record(byte, Bus_Transaction_Kind) {}
+        byte length(void) const { return 0; }
+        const Bus_Transaction &operator[](byte) const {
+            static const Bus_Transaction nothing = {};      // never asked for, there are length() == 0 of them
+            return nothing;
+        }
+};
+
+// Counts what the driver does and how long it keeps the caller waiting. With TRACE_DEPTH above zero it also keeps the last
+// TRACE_DEPTH bus transactions. Every hook that measures time reads micros(), which is about 4us a time on an Uno, so leave this
+// out of builds that don't need it
+template <byte TRACE_DEPTH = 0>
+class LCD_Instrumentation {
+    public:
+        unsigned long bytes_sent(void) const { return _instruction_writes + _data_writes; }
+        unsigned long instruction_writes(void) const { return _instruction_writes; }
+        unsigned long data_writes(void) const { return _data_writes; }
+        unsigned long enable_pulses(void) const { return _enable_pulses; }     // writes plus every poll of the busy flag
+        unsigned long waiting_us(void) const { return _waiting_us; }            // in total, waiting for the display to be ready
+        unsigned long longest_call_us(void) const { return _longest_call_us; } // the longest any one write kept its caller waiting
+        const Bus_Trace<TRACE_DEPTH> &trace(void) const { return _trace; }
+
+        void reset_counters(void) {
+            _instruction_writes = _data_writes = _enable_pulses = 0;
+            _waiting_us = _longest_call_us = 0;
+        }
+
+        // The hooks LCD_Display calls
+        void call_started(void) {
+            _call_started_us = micros();
+        }
+
+        void display_ready(void) {
+            _waiting_us += micros() - _call_started_us;
+        }
+
+        void byte_sent(byte value, byte register_select) {
+            if (register_select) {
+                _data_writes++;
+            }
+            else {
+                _instruction_writes++;
+            }
+            _trace.record(value, register_select ? data_write : instruction_write);
+        }
+
+        void busy_flag_read(byte status) {
+            _trace.record(status, status_read);
+        }
+
+        void enable_pulsed(void) {
+            _enable_pulses++;
+        }
+
+        void call_finished(void) {
+            unsigned long call_us = micros() - _call_started_us;
+            if (call_us > _longest_call_us) {
+                _longest_call_us = call_us;
+            }
+        }
+
+    private:
+        unsigned long _instruction_writes = 0, _data_writes = 0, _enable_pulses = 0;
+        unsigned long _waiting_us = 0, _longest_call_us = 0;
+        unsigned long _call_started_us = 0;
+        Bus_Trace<TRACE_DEPTH> _trace;
+};
+
+// The whole wiring is part of the type, so two displays on different pins are different classes and can't trample each other's bus.
+// The only things left to keep in RAM are the ones that really change while we run
+template <byte RS, byte RW, byte E, byte DB0, byte DB1, byte DB2, byte DB3, byte DB4, byte DB5, byte DB6, byte DB7, typename Timing = HD44780_Timing, typename Instrumentation = No_Instrumentation>
+class LCD_Display: private Instrumentation {
+    public:
+        LCD_Display(void) {
+            // Initialise the device control pins
+            pinMode(RS, OUTPUT);
+            pinMode(E, OUTPUT);
+            digitalWrite(E, LOW);                   // E idles LOW, the display latches whatever is on the bus when it falls
+
+            if constexpr (RW != NOT_CONNECTED) {
+                pinMode(RW, OUTPUT);
+                digitalWrite(RW, LOW);              // LOW = Write mode, HIGH = Read Mode
+            }
+
+            // Initialise the data bus, setting the pins to output and LOW by default
+            Bus::take();
+
+            // Initialise the display. Each write waits for the one before it, so there is no need to sleep after the clear
+            write_byte(instr_fn_set, LOW);
+            write_byte(instr_display_on_no_cursor_blink, LOW);
+            write_byte(instr_entry_mode, LOW);
+            write_byte(instr_clear_disp, LOW);      // Clear the display (This also resets cursor position)
+        }
+
+        void print_text(const String text) {
+            for (byte i = 0; i < text.length(); i++) {
+                write_byte(text[i], HIGH);
+            }
+        }
+
+        bool busy_flag_mode(void) { return _busy_flag_mode; }  // false if we are timing every instruction instead
+        Instrumentation &instrumentation(void) { return *this; }
+
+        typedef Uno_Bus<DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7> Bus;
+
+    private:
+        static_assert(RS < 20 && E < 20 && (RW < 20 || RW == NOT_CONNECTED), "control pins must be D0-D13 or A0-A5");
+        static_assert(DB0 < 20 && DB1 < 20 && DB2 < 20 && DB3 < 20 && DB4 < 20 && DB5 < 20 && DB6 < 20 && DB7 < 20, "data pins must be D0-D13 or A0-A5");
+
+        constexpr static unsigned long _MICROS_RESOLUTION_US = 64000000UL / F_CPU;    // micros() counts in steps of 4us at 16MHz, so we allow for one extra step
+        constexpr static unsigned long _PULSE_TIME_US = 1;     // pulse_enable() takes well under 1us from start to the falling edge
+        constexpr static unsigned long _BUSY_TIMEOUT_US = 3000; // nothing takes longer than 1.53ms (2.16ms on a slow oscillator), so if we are still busy after this, nobody is answering
+
+        bool _busy_flag_mode = RW != NOT_CONNECTED;     // true = poll the busy flag before every write, false = time every write from Timing
+        unsigned long _ready_at_us = micros() + _MICROS_RESOLUTION_US + Timing::CLEAR_US;  // when the display will have finished the last thing we sent it, in timed mode.
+                                                                                        // Whoever had the display before us may have left a clear running
+
+        enum LCD_Instructions: byte {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+        };
+
+        static unsigned int execution_time_us(byte instruction) {
+            return instruction <= instr_return_home ? Timing::CLEAR_US : Timing::INSTRUCTION_US;
+        }
+
+        void pulse_enable(void) {
+            // E is a constant pin on a constant port, so each edge is one sbi or cbi. Those can't be interrupted half way, so no need to turn interrupts off
+            Instrumentation::enable_pulsed();
+            __builtin_avr_delay_cycles(cycles_for_ns(Timing::ADDRESS_SETUP_NS));
+            write_pin<E>(HIGH);
+            __builtin_avr_delay_cycles(cycles_for_ns(Timing::ENABLE_PULSE_NS));
+            write_pin<E>(LOW);                      // the falling edge is what latches the command
+            __builtin_avr_delay_cycles(cycles_for_ns(Timing::DATA_HOLD_NS));
+        }
+
+        void write_byte(byte value, byte register_select) {
+            Instrumentation::call_started();
+            if constexpr (RW != NOT_CONNECTED) {
+                if (_busy_flag_mode) {
+                    wait_until_ready();
+                }
+            }
+
+            write_pin<RS>(register_select);         // LOW = Instruction register selected, HIGH = Data register selected
+            Bus::write(value);
+
+            if (_busy_flag_mode) {
+                Instrumentation::display_ready();
+                pulse_enable();
+                Instrumentation::byte_sent(value, register_select);
+                Instrumentation::call_finished();
+                return;
+            }
+
+            // The display has been executing the last command while we set up this one, so we only wait for whatever time is left
+            unsigned long now_us;
+            do {
+                now_us = micros();
+            } while ((long)(now_us - _ready_at_us) < 0);
+
+            Instrumentation::display_ready();
+            pulse_enable();
+            Instrumentation::byte_sent(value, register_select);
+
+            // E fell within one micros() step of now_us, plus the pulse itself
+            _ready_at_us = now_us + _MICROS_RESOLUTION_US + _PULSE_TIME_US + (register_select ? Timing::DATA_WRITE_US : execution_time_us(value));
+            Instrumentation::call_finished();
+        }
+
+        void wait_until_ready(void) {
+            // Hand the data bus over to the display. DB7 gets a pull up, so if nothing is driving it we read busy and eventually time out
+            Bus::release();
+            write_pin<RS>(LOW);                     // the busy flag is read from the instruction register
+            write_pin<RW>(HIGH);                    // LOW = Write mode, HIGH = Read Mode
+
+            unsigned long started_us = micros();
+            while (read_busy_flag()) {
+                if (micros() - started_us > _BUSY_TIMEOUT_US) {
+                    // RW is probably tied to ground, and every poll has just strobed whatever was floating on the bus into the display.
+                    // Fall back to timed mode for good, and give that junk instruction as long as the slowest one takes to finish.
+                    _busy_flag_mode = false;
+                    _ready_at_us = micros() + _MICROS_RESOLUTION_US + Timing::CLEAR_US;
+                    break;
+                }
+            }
+
+            // Take the data bus back. E is already LOW, so the display has let go of it
+            write_pin<RW>(LOW);
+            Bus::take();
+        }
+
+        bool read_busy_flag(void) {
+            Instrumentation::enable_pulsed();
+            __builtin_avr_delay_cycles(cycles_for_ns(Timing::ADDRESS_SETUP_NS));
+            write_pin<E>(HIGH);                     // the display drives the bus for as long as E is HIGH
+            __builtin_avr_delay_cycles(cycles_for_ns(Timing::ENABLE_PULSE_NS));
+            byte status = Bus::read();              // DB7 is the busy flag, DB0-DB6 hold the address counter
+            write_pin<E>(LOW);
+            Instrumentation::busy_flag_read(status);
+            return status & 0x80;
+        }
+};
+
+// Time printing the same text on a display, and return how many CPU cycles each character took
+template <typename Display>
+unsigned long cycles_per_character(Display &lcd_screen) {
+    const String text = "0123456789ABCDEF";
+
+    unsigned long started_us = micros();
+    lcd_screen.print_text(text);
+    unsigned long elapsed_us = micros() - started_us;
+    return elapsed_us * (F_CPU / 1000000UL) / text.length();
+}
+
+void setup() {
+    // The same display and wiring, built with and without the instrumentation. D11 for RW, so both poll the busy flag
+    typedef LCD_Display<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_LCD_Display;
+    typedef LCD_Display<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2, HD44780_Timing, LCD_Instrumentation<8>> My_Instrumented_LCD_Display;
+
+    Serial.begin(9600);
+
+    My_LCD_Display my_lcd_screen;
+    unsigned long plain_cycles = cycles_per_character(my_lcd_screen);
+
+    My_Instrumented_LCD_Display my_instrumented_lcd_screen;         // runs the init sequence again on the same display, which is harmless
+    auto &counters = my_instrumented_lcd_screen.instrumentation();
+    counters.reset_counters();
+    unsigned long instrumented_cycles = cycles_per_character(my_instrumented_lcd_screen);
+
+    Serial.print("Without instrumentation: ");
+    Serial.print((unsigned int)sizeof(my_lcd_screen));
+    Serial.print(" bytes, ");
+    Serial.print(plain_cycles);
+    Serial.print(" cycles per character. With it: ");
+    Serial.print((unsigned int)sizeof(my_instrumented_lcd_screen));
+    Serial.print(" bytes, ");
+    Serial.print(instrumented_cycles);
+    Serial.println(" cycles per character");
+
+    Serial.print(counters.bytes_sent());
+    Serial.print(" bytes sent (");
+    Serial.print(counters.instruction_writes());
+    Serial.print(" instructions, ");
+    Serial.print(counters.data_writes());
+    Serial.print(" data), ");
+    Serial.print(counters.enable_pulses());
+    Serial.print(" enable pulses, ");
+    Serial.print(counters.waiting_us());
+    Serial.print(" us waiting for the display, longest call ");
+    Serial.print(counters.longest_call_us());
+    Serial.println(" us");
+
+    constexpr const char *KIND_NAMES[] = {"instruction", "data", "status"};
+    for (byte i = 0; i < counters.trace().length(); i++) {
+        const Bus_Transaction &transaction = counters.trace()[i];
+        Serial.print("  ");
+        Serial.print(transaction.at_us);
+        Serial.print(" us: ");
+        Serial.print(KIND_NAMES[transaction.kind]);
+        Serial.print(" 0x");
+        Serial.println(transaction.value, HEX);
+    }
+}
+
+void loop() {
+    // Do nothing for now
+}
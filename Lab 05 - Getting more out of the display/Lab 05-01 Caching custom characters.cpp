@@ -0,0 +1,464 @@
+#include <Arduino.h>
+
+constexpr byte BUS_WIDTH = 8;
+constexpr byte DISPLAY_COLUMNS = 16;
+constexpr byte DISPLAY_ROWS = 2;
+constexpr byte NOT_CONNECTED = 0xFF;    // pass this in as the read/write pin on boards where RW is tied to ground
+constexpr byte GLYPH_ROWS = 8;          // a custom character is 5 pixels wide and 8 rows high, one byte per row with the pixels in the low 5 bits
+constexpr byte CGRAM_SLOTS = 8;         // the display only has room for 8 custom characters at once, shown with character codes 0-7
+constexpr byte MAX_GLYPHS = 32;         // how many glyphs can be registered, they take turns in the 8 slots
+constexpr byte NO_GLYPH = 0xFF;
+
+typedef decltype(portOutputRegister(0)) port_register_pointer;     // volatile uint8_t * on AVR
+
+constexpr unsigned long cycles_for_ns(unsigned long ns) {
+    return (ns * (F_CPU / 1000000UL) + 999) / 1000;
+}
+
+class LCD_Display {
+    public:
+        LCD_Display(byte register_select_pin, byte read_write_pin, byte enable_pin, const byte data_bus_pins[]);
+
+        // Drawing only changes our copy of the screen, nothing goes out to the display until flush() is called
+        void set_cursor(byte column, byte row);
+        void print_text(const String text);
+        void clear(void);
+        void flush(void);
+        bool busy_flag_mode(void) { return _busy_flag_mode; }   // false if we are timing every instruction instead
+
+        // Custom characters. Register as many as you like, and flush() takes care of which ones are in the display's 8 slots.
+        // The rows are not copied, so they must stay put (a static const array is ideal). If more than 8 different glyphs are
+        // on screen at once, the ones that don't fit show their fallback character instead
+        byte add_glyph(const byte rows[GLYPH_ROWS], char fallback = '#');      // returns the glyph's number, or NO_GLYPH if there is no room
+        void print_glyph(byte glyph);
+
+        // How well the cache is doing. A lookup is one glyph needed by one flush(), however many cells it is in
+        unsigned long glyph_hits(void) { return _glyph_hits; }
+        unsigned long glyph_misses(void) { return _glyph_misses; }         // each miss cost 9 writes to upload the glyph
+        unsigned long glyph_evictions(void) { return _glyph_evictions; }   // misses that had to throw another glyph out of its slot
+
+    private:
+        // Device control pins
+        const byte _REGISTER_SELECT_PIN;
+        const byte _READ_WRITE_PIN;
+        const byte _ENABLE_PIN;
+
+        // The enable strobe has to be timed to within a few hundred nanoseconds, far quicker than digitalWrite(), so we write its port directly
+        port_register_pointer _enable_port;
+        const byte _enable_mask;
+
+        // Device data bus pins
+        static byte _data_bus_pins[BUS_WIDTH];     // declared static because other devices can share the same data bus, no need to have separate data busses for multiple devices.
+
+        // Shadow copies of DDRAM. _screen is what we want showing, _on_display is what we know the display has
+        byte _screen[DISPLAY_ROWS][DISPLAY_COLUMNS];
+        byte _on_display[DISPLAY_ROWS][DISPLAY_COLUMNS];
+        byte _cursor_column = 0, _cursor_row = 0;
+        byte _address_counter = 0;      // where the display will put the next character, it moves along by one after every write
+        constexpr static byte _UNKNOWN_ADDRESS = 0xFF;  // what _address_counter is set to when it isn't pointing into DDRAM
+        constexpr static byte _ROW_ADDRESS[DISPLAY_ROWS] = {0x00, 0x40};  // DDRAM address of the first character on each row
+
+        // The glyph cache. Cells with a glyph in them get the glyph's slot number written into _screen by flush()
+        const byte *_glyphs[MAX_GLYPHS];
+        char _glyph_fallbacks[MAX_GLYPHS];
+        byte _glyph_count = 0;
+        byte _cell_glyphs[DISPLAY_ROWS][DISPLAY_COLUMNS];   // which glyph each cell should show, or NO_GLYPH for a normal character
+        byte _slot_glyphs[CGRAM_SLOTS];                     // which glyph is in each slot, or NO_GLYPH
+        unsigned int _slot_used_at[CGRAM_SLOTS];            // the last flush() that needed each slot, the one needed longest ago is evicted first
+        unsigned int _flush_count = 0;
+        uint16_t _stale_cells[DISPLAY_ROWS];                // one bit per column, cells showing a slot that has since been given a different glyph
+        unsigned long _glyph_hits = 0, _glyph_misses = 0, _glyph_evictions = 0;
+
+        // Device timings. Execution times from the datasheet (Table 6, fosc = 270kHz), indexed by the highest bit set in the instruction
+        constexpr static unsigned int _EXECUTION_TIME_US[8] = {
+            1520,   // 0b00000001 clear display
+            1520,   // 0b0000001x return home
+            37,     // 0b000001xx entry mode set
+            37,     // 0b00001xxx display on/off control
+            37,     // 0b0001xxxx cursor or display shift
+            37,     // 0b001xxxxx function set
+            37,     // 0b01xxxxxx set CGRAM address
+            37,     // 0b1xxxxxxx set DDRAM address
+        };
+        constexpr static unsigned int _DATA_WRITE_TIME_US = 37 + 4;    // writing data takes 37us, then tADD of 4us before the address counter moves
+        constexpr static unsigned long _MICROS_RESOLUTION_US = 64000000UL / F_CPU;    // micros() counts in steps of 4us at 16MHz, so we allow for one extra step
+        constexpr static unsigned long _PULSE_TIME_US = 1;     // pulse_enable() takes well under 1us from start to the falling edge
+        constexpr static unsigned long _BUSY_TIMEOUT_US = 3000; // nothing takes longer than 1.53ms (2.16ms on a slow oscillator), so if we are still busy after this, nobody is answering
+
+        // Bus timings from the datasheet (Figure 25), converted to CPU cycles and rounded up
+        constexpr static unsigned long _ADDRESS_SETUP_CYCLES = cycles_for_ns(40);     // tAS, RS and RW must settle before E rises
+        constexpr static unsigned long _ENABLE_PULSE_CYCLES = cycles_for_ns(230);     // PWEH, E must stay HIGH this long. Also covers tDDR (160ns) on a read
+        constexpr static unsigned long _DATA_HOLD_CYCLES = cycles_for_ns(10);         // tH, the bus must not change straight after E falls
+
+        bool _busy_flag_mode;   // true = poll the busy flag before every write, false = time every write from the table above
+        unsigned long _ready_at_us = 0;     // when the display will have finished the last thing we sent it, in timed mode
+
+        enum LCD_Instructions: byte {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+            instr_set_cgram_addr                = 0b01000000, // 0x40 Set CGRAM address, OR the address into the lower 6 bits. Each slot is 8 bytes
+            instr_set_ddram_addr                = 0b10000000, // 0x80 Set DDRAM address, OR the address into the lower 7 bits
+        };
+
+        byte glyph_slot(byte glyph);
+        void upload_glyph(byte slot, byte glyph);
+
+        static unsigned int execution_time_us(byte instruction);
+        void pulse_enable(void);
+        void send_command(byte command);
+        void write_byte(byte value, byte register_select);
+        void wait_until_ready(void);
+        bool read_busy_flag(void);
+};
+
+byte LCD_Display::_data_bus_pins[BUS_WIDTH] = {0, 0, 0, 0, 0, 0, 0, 0}; // we are forced to initialize this static array, but can change it at any time during run time.
+
+LCD_Display::LCD_Display(byte register_select_pin, byte read_write_pin, byte enable_pin, const byte data_bus_pins[])
+    :  _REGISTER_SELECT_PIN(register_select_pin), _READ_WRITE_PIN(read_write_pin), _ENABLE_PIN(enable_pin),
+       _enable_port(portOutputRegister(digitalPinToPort(enable_pin))), _enable_mask(digitalPinToBitMask(enable_pin)),
+       _busy_flag_mode(read_write_pin != NOT_CONNECTED)
+{
+    // Initialise the device control pins
+    pinMode(_REGISTER_SELECT_PIN, OUTPUT);
+    pinMode(_ENABLE_PIN, OUTPUT);
+    digitalWrite(_ENABLE_PIN, LOW);                 // E idles LOW, the display latches whatever is on the bus when it falls
+
+    if (_busy_flag_mode) {
+        pinMode(_READ_WRITE_PIN, OUTPUT);
+        digitalWrite(_READ_WRITE_PIN, LOW);         // LOW = Write mode, HIGH = Read Mode
+    }
+
+    // Initialise the data bus pins, setting the pin modes to output and setting the pins LOW by default
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        LCD_Display::_data_bus_pins[i] = data_bus_pins[i];
+        pinMode(_data_bus_pins[i], OUTPUT);
+        digitalWrite(_data_bus_pins[i], LOW);
+    }
+
+    // Initialise the display. Each write waits for the one before it, so there is no need to sleep after the clear any more
+    write_byte(instr_fn_set, LOW);
+    write_byte(instr_display_on_no_cursor_blink, LOW);
+    write_byte(instr_entry_mode, LOW);
+    write_byte(instr_clear_disp, LOW);              // Clear the display (This also resets cursor position)
+
+    // The display is now blank with the address counter at the start of the first row, and our copies have to match
+    for (byte row = 0; row < DISPLAY_ROWS; row++) {
+        for (byte column = 0; column < DISPLAY_COLUMNS; column++) {
+            _screen[row][column] = ' ';
+            _on_display[row][column] = ' ';
+            _cell_glyphs[row][column] = NO_GLYPH;
+        }
+        _stale_cells[row] = 0;
+    }
+
+    // All the slots start out empty
+    for (byte slot = 0; slot < CGRAM_SLOTS; slot++) {
+        _slot_glyphs[slot] = NO_GLYPH;
+        _slot_used_at[slot] = 0;
+    }
+}
+
+void LCD_Display::set_cursor(byte column, byte row) {
+    _cursor_column = column < DISPLAY_COLUMNS ? column : DISPLAY_COLUMNS;
+    _cursor_row = row < DISPLAY_ROWS ? row : DISPLAY_ROWS - 1;
+}
+
+void LCD_Display::print_text(const String text) {
+    // Anything past the end of the row is cut off
+    for (byte i = 0; i < text.length() && _cursor_column < DISPLAY_COLUMNS; i++) {
+        _cell_glyphs[_cursor_row][_cursor_column] = NO_GLYPH;
+        _screen[_cursor_row][_cursor_column++] = text[i];
+    }
+}
+
+byte LCD_Display::add_glyph(const byte rows[GLYPH_ROWS], char fallback) {
+    if (_glyph_count == MAX_GLYPHS) {
+        return NO_GLYPH;
+    }
+    _glyphs[_glyph_count] = rows;
+    _glyph_fallbacks[_glyph_count] = fallback;
+    return _glyph_count++;
+}
+
+void LCD_Display::print_glyph(byte glyph) {
+    if (_cursor_column < DISPLAY_COLUMNS && glyph < _glyph_count) {
+        _cell_glyphs[_cursor_row][_cursor_column++] = glyph;    // flush() works out which character code this ends up as
+    }
+}
+
+void LCD_Display::clear(void) {
+    for (byte row = 0; row < DISPLAY_ROWS; row++) {
+        for (byte column = 0; column < DISPLAY_COLUMNS; column++) {
+            _screen[row][column] = ' ';
+            _cell_glyphs[row][column] = NO_GLYPH;
+        }
+    }
+    set_cursor(0, 0);
+}
+
+void LCD_Display::flush(void) {
+    // Make sure every glyph on screen has a slot first. Uploading a glyph moves the address counter into CGRAM, so this has to happen
+    // before we start on DDRAM, and any cell still showing a slot that was given a new glyph is marked stale so it gets rewritten below
+    _flush_count++;
+    for (byte row = 0; row < DISPLAY_ROWS; row++) {
+        for (byte column = 0; column < DISPLAY_COLUMNS; column++) {
+            byte glyph = _cell_glyphs[row][column];
+            if (glyph != NO_GLYPH) {
+                _screen[row][column] = glyph_slot(glyph);
+            }
+        }
+    }
+
+    for (byte row = 0; row < DISPLAY_ROWS; row++) {
+        for (byte column = 0; column < DISPLAY_COLUMNS; column++) {
+            // A stale cell that wants the glyph now in its slot already shows it, the display redraws from CGRAM by itself
+            bool stale = _stale_cells[row] & (1U << column);
+            _stale_cells[row] &= ~(1U << column);
+            if (_screen[row][column] == _on_display[row][column] && (!stale || _cell_glyphs[row][column] != NO_GLYPH)) {
+                continue;
+            }
+
+            // Get the address counter to this cell, either by rewriting the unchanged cells in between and letting it
+            // count along by itself, or with a set DDRAM address instruction, whichever the display gets through quicker
+            byte address = _ROW_ADDRESS[row] + column;
+            byte gap = address - _address_counter;
+            bool same_row = _address_counter >= _ROW_ADDRESS[row] && _address_counter < address;
+
+            if (same_row && gap * _DATA_WRITE_TIME_US < execution_time_us(instr_set_ddram_addr)) {
+                for (byte skipped = column - gap; skipped < column; skipped++) {
+                    write_byte(_on_display[row][skipped], HIGH);
+                }
+            }
+            else if (address != _address_counter) {
+                write_byte(instr_set_ddram_addr | address, LOW);
+            }
+
+            write_byte(_screen[row][column], HIGH);
+            _on_display[row][column] = _screen[row][column];
+            _address_counter = address + 1;
+        }
+    }
+}
+
+byte LCD_Display::glyph_slot(byte glyph) {
+    // Already in a slot
+    for (byte slot = 0; slot < CGRAM_SLOTS; slot++) {
+        if (_slot_glyphs[slot] == glyph) {
+            if (_slot_used_at[slot] != _flush_count) {
+                _glyph_hits++;                      // only count the first cell that needs it in each flush()
+                _slot_used_at[slot] = _flush_count;
+            }
+            return slot;
+        }
+    }
+
+    // Not in a slot, so find one for it. An empty slot if there is one, otherwise whichever was needed longest ago,
+    // as long as that wasn't this flush(), or we would be pulling a glyph out from under a cell we have only just placed it in
+    _glyph_misses++;
+    byte victim = NO_GLYPH;
+    for (byte slot = 0; slot < CGRAM_SLOTS; slot++) {
+        if (_slot_glyphs[slot] == NO_GLYPH) {
+            victim = slot;
+            break;
+        }
+        if (_slot_used_at[slot] != _flush_count && (victim == NO_GLYPH || _flush_count - _slot_used_at[slot] > _flush_count - _slot_used_at[victim])) {
+            victim = slot;
+        }
+    }
+    if (victim == NO_GLYPH) {
+        return _glyph_fallbacks[glyph];             // more than 8 different glyphs on screen at once
+    }
+
+    // Every cell showing the old glyph would change to the new one the moment it is uploaded, so they all have to be drawn again
+    if (_slot_glyphs[victim] != NO_GLYPH) {
+        _glyph_evictions++;
+        for (byte row = 0; row < DISPLAY_ROWS; row++) {
+            for (byte column = 0; column < DISPLAY_COLUMNS; column++) {
+                if (_on_display[row][column] == victim) {
+                    _stale_cells[row] |= 1U << column;
+                }
+            }
+        }
+    }
+
+    upload_glyph(victim, glyph);
+    _slot_glyphs[victim] = glyph;
+    _slot_used_at[victim] = _flush_count;
+    return victim;
+}
+
+void LCD_Display::upload_glyph(byte slot, byte glyph) {
+    write_byte(instr_set_cgram_addr | (slot * GLYPH_ROWS), LOW);
+    for (byte row = 0; row < GLYPH_ROWS; row++) {
+        write_byte(_glyphs[glyph][row], HIGH);
+    }
+    _address_counter = _UNKNOWN_ADDRESS;            // it is pointing into CGRAM now, the next DDRAM write has to set the address
+}
+
+unsigned int LCD_Display::execution_time_us(byte instruction) {
+    byte highest_bit = 7;
+    while (highest_bit > 0 && !(instruction & (1 << highest_bit))) {
+        highest_bit--;
+    }
+    return _EXECUTION_TIME_US[highest_bit];
+}
+
+void LCD_Display::pulse_enable(void) {
+    // E shares its port with other pins, so nothing may touch that port between our read and write. This also keeps the pulse exactly as long as we asked
+    noInterrupts();
+    __builtin_avr_delay_cycles(_ADDRESS_SETUP_CYCLES);
+    *_enable_port |= _enable_mask;
+    __builtin_avr_delay_cycles(_ENABLE_PULSE_CYCLES);
+    *_enable_port &= ~_enable_mask;                 // the falling edge is what latches the command
+    __builtin_avr_delay_cycles(_DATA_HOLD_CYCLES);
+    interrupts();
+}
+
+void LCD_Display::send_command(byte command) {
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        digitalWrite(LCD_Display::_data_bus_pins[i], (command >> i) & 1);
+    }
+}
+
+void LCD_Display::write_byte(byte value, byte register_select) {
+    if (_busy_flag_mode) {
+        wait_until_ready();
+    }
+
+    digitalWrite(_REGISTER_SELECT_PIN, register_select);   // LOW = Instruction register selected, HIGH = Data register selected
+    send_command(value);
+
+    if (_busy_flag_mode) {
+        pulse_enable();
+        return;
+    }
+
+    // The display has been executing the last command while we set up this one, so we only wait for whatever time is left
+    unsigned long now_us;
+    do {
+        now_us = micros();
+    } while ((long)(now_us - _ready_at_us) < 0);
+
+    pulse_enable();
+
+    // Rather than sleeping now, note when the display will be done and let the caller get on with something else.
+    // E fell within one micros() step of now_us, plus the pulse itself
+    _ready_at_us = now_us + _MICROS_RESOLUTION_US + _PULSE_TIME_US + (register_select ? _DATA_WRITE_TIME_US : execution_time_us(value));
+}
+
+void LCD_Display::wait_until_ready(void) {
+    // Hand the data bus over to the display. DB7 gets a pull up, so if nothing is driving it we read busy and eventually time out
+    for (byte i = 0; i < BUS_WIDTH - 1; i++) {
+        pinMode(_data_bus_pins[i], INPUT);
+    }
+    pinMode(_data_bus_pins[BUS_WIDTH - 1], INPUT_PULLUP);
+    digitalWrite(_REGISTER_SELECT_PIN, LOW);        // the busy flag is read from the instruction register
+    digitalWrite(_READ_WRITE_PIN, HIGH);            // LOW = Write mode, HIGH = Read Mode
+
+    unsigned long started_us = micros();
+    while (read_busy_flag()) {
+        if (micros() - started_us > _BUSY_TIMEOUT_US) {
+            // RW is probably tied to ground, and every poll has just strobed whatever was floating on the bus into the display.
+            // Fall back to timed mode for good, and give that junk instruction as long as the slowest one takes to finish.
+            _busy_flag_mode = false;
+            _ready_at_us = micros() + _MICROS_RESOLUTION_US + _EXECUTION_TIME_US[0];
+            break;
+        }
+    }
+
+    // Take the data bus back. E is already LOW, so the display has let go of it
+    digitalWrite(_READ_WRITE_PIN, LOW);
+    for (byte i = 0; i < BUS_WIDTH; i++) {
+        pinMode(_data_bus_pins[i], OUTPUT);
+    }
+}
+
+bool LCD_Display::read_busy_flag(void) {
+    noInterrupts();
+    __builtin_avr_delay_cycles(_ADDRESS_SETUP_CYCLES);
+    *_enable_port |= _enable_mask;                  // the display drives the bus for as long as E is HIGH
+    __builtin_avr_delay_cycles(_ENABLE_PULSE_CYCLES);
+    interrupts();
+    bool busy = digitalRead(_data_bus_pins[BUS_WIDTH - 1]);    // DB7 is the busy flag, DB0-DB6 hold the address counter
+    noInterrupts();
+    *_enable_port &= ~_enable_mask;
+    interrupts();
+    return busy;
+}
+
+// A few icons, one byte per row with the pixels in the low 5 bits
+constexpr byte HEART[GLYPH_ROWS]    = {0b00000, 0b01010, 0b11111, 0b11111, 0b11111, 0b01110, 0b00100, 0b00000};
+constexpr byte BELL[GLYPH_ROWS]     = {0b00100, 0b01110, 0b01110, 0b01110, 0b11111, 0b00000, 0b00100, 0b00000};
+constexpr byte NOTE[GLYPH_ROWS]     = {0b00010, 0b00011, 0b00010, 0b00010, 0b01110, 0b11110, 0b01100, 0b00000};
+constexpr byte SMILEY[GLYPH_ROWS]   = {0b00000, 0b01010, 0b01010, 0b00000, 0b10001, 0b01110, 0b00000, 0b00000};
+constexpr byte ICON_COUNT = 4;
+
+// Bars for a bar graph, 1 to 7 rows high. Together with one icon that is exactly 8 glyphs on screen at once
+constexpr byte BAR_HEIGHTS = 7;
+byte bar_rows[BAR_HEIGHTS][GLYPH_ROWS];
+
+LCD_Display *my_lcd_screen;
+byte icons[ICON_COUNT];
+byte bars[BAR_HEIGHTS];
+unsigned long last_update_ms = 0;
+unsigned int frame = 0;
+
+void setup() {
+    constexpr byte REGISTER_SELECT_PIN = D12;
+    constexpr byte READ_WRITE_PIN = NOT_CONNECTED;  // timed mode. Use D11 here to poll the busy flag instead, RW must be held LOW if it is wired up but not used
+    constexpr byte ENABLE_PIN = D10;
+    constexpr byte DATA_BUS[8] = {D9, D8, D7, D6, D5, D4, D3, D2};
+
+    Serial.begin(9600);
+
+    static LCD_Display lcd_screen(REGISTER_SELECT_PIN, READ_WRITE_PIN, ENABLE_PIN, DATA_BUS);   // static, so it outlives setup() and loop() can use it
+    my_lcd_screen = &lcd_screen;
+
+    // Register more glyphs than there are slots, the cache works out which ones need to be on the display
+    icons[0] = my_lcd_screen->add_glyph(HEART, '*');
+    icons[1] = my_lcd_screen->add_glyph(BELL, '*');
+    icons[2] = my_lcd_screen->add_glyph(NOTE, '*');
+    icons[3] = my_lcd_screen->add_glyph(SMILEY, '*');
+    for (byte height = 1; height <= BAR_HEIGHTS; height++) {
+        for (byte row = 0; row < GLYPH_ROWS; row++) {
+            bar_rows[height - 1][row] = row >= GLYPH_ROWS - height ? 0b11111 : 0b00000;
+        }
+        bars[height - 1] = my_lcd_screen->add_glyph(bar_rows[height - 1], '0' + height);
+    }
+}
+
+void loop() {
+    // A bar graph that scrolls along, redrawn fifty times a second, with the icon in the corner changing every tenth of a second.
+    // Only a changed icon misses the cache, the bars are already in their slots and only the cells that changed go out to the display
+    if (millis() - last_update_ms < 20) {
+        return;
+    }
+    last_update_ms = millis();
+    frame++;
+
+    my_lcd_screen->clear();
+    my_lcd_screen->print_text("Hello World!!");
+    my_lcd_screen->set_cursor(DISPLAY_COLUMNS - 1, 0);
+    my_lcd_screen->print_glyph(icons[(frame / 5) % ICON_COUNT]);
+
+    my_lcd_screen->set_cursor(0, 1);
+    for (byte column = 0; column < DISPLAY_COLUMNS; column++) {
+        byte phase = (column + frame) % (2 * BAR_HEIGHTS - 2);      // up from 1 to 7 and back down again
+        byte height = phase < BAR_HEIGHTS ? phase + 1 : 2 * BAR_HEIGHTS - 1 - phase;
+        my_lcd_screen->print_glyph(bars[height - 1]);
+    }
+    my_lcd_screen->flush();
+
+    if (frame % 5 == 0) {
+        Serial.print("glyph cache: ");
+        Serial.print(my_lcd_screen->glyph_hits());
+        Serial.print(" hits, ");
+        Serial.print(my_lcd_screen->glyph_misses());
+        Serial.print(" misses, ");
+        Serial.print(my_lcd_screen->glyph_evictions());
+        Serial.println(" evictions");
+    }
+}
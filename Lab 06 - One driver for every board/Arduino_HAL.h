@@ -0,0 +1,162 @@
+#pragma once
+
+#include <Arduino.h>
+
+// The HAL for an Arduino Uno, with the pins fixed at compile time the same way as Lab 04-06
+
+constexpr byte NOT_CONNECTED = 0xFF;    // pass this in as the read/write pin on boards where RW is tied to ground
+
+constexpr unsigned long cycles_for_ns(unsigned long ns) {
+    return (ns * (F_CPU / 1000000UL) + 999) / 1000;
+}
+
+// D0-D7 are PORTD, D8-D13 are PORTB and A0-A5 are PORTC
+constexpr byte uno_port(byte pin) {
+    return pin < 8 ? PD : pin < 14 ? PB : PC;
+}
+
+constexpr byte uno_bit_mask(byte pin) {
+    return 1 << (pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14);
+}
+
+template <byte PORT>
+inline auto &output_register(void) {
+    if constexpr (PORT == PB) return PORTB;
+    else if constexpr (PORT == PC) return PORTC;
+    else return PORTD;
+}
+
+template <byte PORT>
+inline auto &input_register(void) {
+    if constexpr (PORT == PB) return PINB;
+    else if constexpr (PORT == PC) return PINC;
+    else return PIND;
+}
+
+template <byte PORT>
+inline auto &mode_register(void) {
+    if constexpr (PORT == PB) return DDRB;
+    else if constexpr (PORT == PC) return DDRC;
+    else return DDRD;
+}
+
+template <byte PIN>
+inline void write_pin(bool level) {
+    if (level) {
+        output_register<uno_port(PIN)>() |= uno_bit_mask(PIN);
+    }
+    else {
+        output_register<uno_port(PIN)>() &= (byte)~uno_bit_mask(PIN);
+    }
+}
+
+template <byte RS, byte RW, byte E, byte DB0, byte DB1, byte DB2, byte DB3, byte DB4, byte DB5, byte DB6, byte DB7>
+class Uno_HAL {
+    public:
+        static_assert(RS < 20 && E < 20 && (RW < 20 || RW == NOT_CONNECTED), "control pins must be D0-D13 or A0-A5");
+        static_assert(DB0 < 20 && DB1 < 20 && DB2 < 20 && DB3 < 20 && DB4 < 20 && DB5 < 20 && DB6 < 20 && DB7 < 20, "data pins must be D0-D13 or A0-A5");
+
+        constexpr static bool HAS_READ_WRITE = RW != NOT_CONNECTED;
+        constexpr static uint32_t NOW_RESOLUTION_US = 64000000UL / F_CPU;     // micros() counts in steps of 4us at 16MHz
+
+        static void begin(void) {
+            pinMode(RS, OUTPUT);
+            pinMode(E, OUTPUT);
+            digitalWrite(E, LOW);                   // E idles LOW, the display latches whatever is on the bus when it falls
+            if constexpr (HAS_READ_WRITE) {
+                pinMode(RW, OUTPUT);
+                digitalWrite(RW, LOW);              // LOW = Write mode, HIGH = Read Mode
+            }
+            take_bus();
+        }
+
+        // E, RS and RW are constant pins on constant ports, so each of these is one sbi or cbi
+        static void write_register_select(bool level) { write_pin<RS>(level); }
+        static void write_read_write(bool level) { write_pin<RW>(level); }
+        static void write_enable(bool level) { write_pin<E>(level); }
+
+        static void write_bus(byte value) {
+            // The other pins on these ports belong to someone else, so nothing may change them between our read and our write
+            noInterrupts();
+            write_port<PB>(value);
+            write_port<PC>(value);
+            write_port<PD>(value);
+            interrupts();
+        }
+
+        static byte read_bus(void) {
+            return read_port<PB>() | read_port<PC>() | read_port<PD>();
+        }
+
+        static void release_bus(void) {
+            noInterrupts();
+            set_direction<PB>(false);
+            set_direction<PC>(false);
+            set_direction<PD>(false);
+            write_pin<DB7>(HIGH);                   // on an input pin PORTx turns the pull up on
+            interrupts();
+        }
+
+        static void take_bus(void) {
+            noInterrupts();
+            set_direction<PB>(true);
+            set_direction<PC>(true);
+            set_direction<PD>(true);
+            interrupts();
+        }
+
+        // Like _delay_us(), this needs a constant and optimisation turned on to become an exact number of cycles
+        static void delay_ns(uint32_t ns) { __builtin_avr_delay_cycles(cycles_for_ns(ns)); }
+        static uint32_t now_us(void) { return micros(); }
+
+    private:
+        constexpr static byte _PINS[8] = {DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7};
+
+        // Which bits of a port belong to the bus, worked out by the compiler
+        constexpr static byte port_mask(byte port) {
+            byte mask = 0;
+            for (byte i = 0; i < 8; i++) {
+                if (uno_port(_PINS[i]) == port) mask |= uno_bit_mask(_PINS[i]);
+            }
+            return mask;
+        }
+
+        template <byte PORT>
+        static void write_port(byte value) {
+            constexpr byte MASK = port_mask(PORT);
+            if constexpr (MASK != 0) {              // ports the bus isn't on don't generate any code at all
+                byte levels = 0;
+                for (byte i = 0; i < 8; i++) {      // every test and mask here is a constant, so this unrolls into a handful of bit moves
+                    if (uno_port(_PINS[i]) == PORT && (value & (1 << i))) levels |= uno_bit_mask(_PINS[i]);
+                }
+                output_register<PORT>() = (output_register<PORT>() & (byte)~MASK) | levels;
+            }
+        }
+
+        template <byte PORT>
+        static byte read_port(void) {
+            constexpr byte MASK = port_mask(PORT);
+            byte value = 0;
+            if constexpr (MASK != 0) {
+                byte levels = input_register<PORT>();
+                for (byte i = 0; i < 8; i++) {
+                    if (uno_port(_PINS[i]) == PORT && (levels & uno_bit_mask(_PINS[i]))) value |= 1 << i;
+                }
+            }
+            return value;
+        }
+
+        template <byte PORT>
+        static void set_direction(bool output) {
+            constexpr byte MASK = port_mask(PORT);
+            if constexpr (MASK != 0) {
+                output_register<PORT>() &= (byte)~MASK;   // drop any pull ups first, so DB7 doesn't come up HIGH when it starts driving
+                if (output) {
+                    mode_register<PORT>() |= MASK;
+                }
+                else {
+                    mode_register<PORT>() &= (byte)~MASK;
+                }
+            }
+        }
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Simulated_Board.h"
+
+// The HAL for a Linux PC, with no board at all. The driver drives the simulated board directly, the same one that sits behind
+// our Arduino.h and mbed.h shims, so it can be developed and checked against the simulated HD44780 before it goes near hardware.
+// Pins are the board's own numbers, wired the way Simulated_Board.h describes
+namespace host_costs {
+    constexpr uint32_t CPU_HZ = 1000000000;     // a 1GHz single board computer
+    constexpr uint32_t GPIO_ACCESS = 20;        // a store or load to a memory mapped GPIO register, which the cache can't help with
+    constexpr uint32_t CLOCK_READ = 20;         // reading the free running timer, another uncached register
+}
+
+template <uint8_t DISPLAY = 0, bool READ_WRITE_WIRED = true>
+class Host_HAL {
+    public:
+        static_assert(DISPLAY < Simulated_Board::DISPLAY_COUNT, "the simulated board has four displays");
+
+        constexpr static bool HAS_READ_WRITE = READ_WRITE_WIRED;
+        constexpr static uint32_t NOW_RESOLUTION_US = 1;
+
+        static void begin(void) {
+            simulated_board.set_cpu_frequency(host_costs::CPU_HZ);
+            simulated_board.pin_mode(_ENABLE_PIN, Simulated_Board::mode_output);
+            simulated_board.pin_mode(Simulated_Board::REGISTER_SELECT_PIN, Simulated_Board::mode_output);
+            if constexpr (HAS_READ_WRITE) {
+                simulated_board.pin_mode(Simulated_Board::READ_WRITE_PIN, Simulated_Board::mode_output);
+            }
+            simulated_board.write_pins(_CONTROL_MASK | _BUS_MASK, 0);  // E idles LOW, RW LOW = Write mode
+            take_bus();
+        }
+
+        static void write_register_select(bool level) { write_pin(Simulated_Board::REGISTER_SELECT_PIN, level); }
+        static void write_read_write(bool level) { write_pin(Simulated_Board::READ_WRITE_PIN, level); }
+        static void write_enable(bool level) { write_pin(_ENABLE_PIN, level); }
+
+        static void write_bus(uint8_t value) {
+            uint32_t levels = 0;
+            for (uint8_t i = 0; i < 8; i++) {
+                if (value & (1 << i)) levels |= 1UL << Simulated_Board::DATA_BUS_PINS[i];
+            }
+            simulated_board.gpio_access(host_costs::GPIO_ACCESS);
+            simulated_board.write_pins(_BUS_MASK, levels);
+        }
+
+        static uint8_t read_bus(void) {
+            simulated_board.gpio_access(host_costs::GPIO_ACCESS);
+            uint8_t value = 0;
+            for (uint8_t i = 0; i < 8; i++) {
+                if (simulated_board.read_pin(Simulated_Board::DATA_BUS_PINS[i])) value |= 1 << i;
+            }
+            return value;
+        }
+
+        static void release_bus(void) {
+            simulated_board.gpio_access(host_costs::GPIO_ACCESS);
+            for (uint8_t i = 0; i < 7; i++) {
+                simulated_board.pin_mode(Simulated_Board::DATA_BUS_PINS[i], Simulated_Board::mode_input);
+            }
+            simulated_board.pin_mode(Simulated_Board::DATA_BUS_PINS[7], Simulated_Board::mode_input_pullup);
+        }
+
+        static void take_bus(void) {
+            simulated_board.gpio_access(host_costs::GPIO_ACCESS);
+            simulated_board.write_pins(_BUS_MASK, 0);
+            for (uint8_t i = 0; i < 8; i++) {
+                simulated_board.pin_mode(Simulated_Board::DATA_BUS_PINS[i], Simulated_Board::mode_output);
+            }
+        }
+
+        static void delay_ns(uint32_t ns) { simulated_board.advance_ns(ns); }
+        static uint32_t now_us(void) {
+            simulated_board.advance_cycles(host_costs::CLOCK_READ);
+            return uint32_t(simulated_board.now_ns() / 1000);
+        }
+
+    private:
+        constexpr static uint8_t _ENABLE_PIN = Simulated_Board::ENABLE_PINS[DISPLAY];
+
+        constexpr static uint32_t bus_mask(void) {
+            uint32_t mask = 0;
+            for (uint8_t pin : Simulated_Board::DATA_BUS_PINS) {
+                mask |= 1UL << pin;
+            }
+            return mask;
+        }
+
+        constexpr static uint32_t _BUS_MASK = bus_mask();
+        constexpr static uint32_t _CONTROL_MASK = 1UL << Simulated_Board::REGISTER_SELECT_PIN | 1UL << Simulated_Board::READ_WRITE_PIN | 1UL << _ENABLE_PIN;
+
+        static void write_pin(uint8_t pin, bool level) {
+            simulated_board.gpio_access(host_costs::GPIO_ACCESS);
+            simulated_board.write_pin(pin, level);
+        }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Simulated_Board.h"
+#include "LCD_Waveform.h"
+
+// Plays a waveform into the simulated board the way the timer and DMA do on the STM32: one step every STEP_NS, each word applied
+// to the pins as a set/reset register would, and no CPU time spent along the way. The simulated board's pins are all on one port
+template <uint8_t DISPLAY = 0>
+struct Host_Waveform_Pins {
+    static_assert(Simulated_Board::ENABLE_PINS[DISPLAY] < 16, "a set/reset word only has room for pins 0-15");
+
+    constexpr static uint8_t PORT_COUNT = 1;
+    constexpr static Port_Pin RS = {0, Simulated_Board::REGISTER_SELECT_PIN};
+    constexpr static Port_Pin E = {0, Simulated_Board::ENABLE_PINS[DISPLAY]};
+    constexpr static Port_Pin DATA[8] = {
+        {0, Simulated_Board::DATA_BUS_PINS[0]}, {0, Simulated_Board::DATA_BUS_PINS[1]}, {0, Simulated_Board::DATA_BUS_PINS[2]}, {0, Simulated_Board::DATA_BUS_PINS[3]},
+        {0, Simulated_Board::DATA_BUS_PINS[4]}, {0, Simulated_Board::DATA_BUS_PINS[5]}, {0, Simulated_Board::DATA_BUS_PINS[6]}, {0, Simulated_Board::DATA_BUS_PINS[7]},
+    };
+};
+
+class Host_Waveform_Player {
+    public:
+        // Returns once the last step has gone out, the display may still be busy with it for STEP_NS * STEPS_PER_WRITE
+        template <typename Waveform>
+        static void play(const Waveform &waveform) {
+            static_assert(Waveform::PORT_COUNT == 1, "the simulated board has one port");
+
+            const uint32_t *words = waveform.words(0);
+            for (uint16_t step = 0; step < waveform.length(); step++) {
+                uint32_t set = words[step] & 0xFFFF, reset = words[step] >> 16;
+                simulated_board.write_pins(set | reset, set);
+                simulated_board.advance_ns(Waveform::STEP_NS);
+            }
+        }
+};
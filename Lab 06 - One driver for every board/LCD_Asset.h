@@ -0,0 +1,276 @@
+#pragma once
+
+#include <stdint.h>
+#include "LCD_Display.h"
+
+// On an AVR a constant isn't left in flash just because it is constexpr, it is copied into RAM at startup like any other
+// variable. Declare assets PROGMEM to keep them in flash, and they are read back a byte at a time with pgm_read_byte().
+// Everywhere else const data stays in flash anyway, and PROGMEM means nothing
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#endif
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+// The boot screen, the menu, the alarm. Screens that never change don't need to be put together at run time out of Strings and
+// print_text() calls, using RAM for the text and time for the formatting. Describe them once with an LCD_Screen, and the compiler
+// works out every byte that has to go to the display, packs it into an LCD_Asset, and leaves it in flash:
+//
+//      constexpr auto ALARM_SCREEN PROGMEM = lcd_asset([] {
+//          LCD_Screen screen;
+//          screen.glyph(0, BELL).character(0, 0, 0).text(2, 0, "Alarm 07:30");
+//          return screen;
+//      });
+//      ...
+//      my_lcd_screen->play(ALARM_SCREEN);
+//
+// The asset is exactly as big as it needs to be, and knows what it will cost. ALARM_SCREEN.size() is the bytes it takes in flash,
+// transactions() how many writes to the display it makes, and draw_time_us() how long the display will spend executing them. All
+// three are constants, so they can be printed, or checked with a static_assert.
+//
+// An asset is the display's bus transactions, run length encoded. Each run starts with a tag byte, the top two bits say what kind
+// of run it is and the bottom six how long:
+//      00nnnnnn    n data bytes follow, each one written as it is
+//      01nnnnnn    one data byte follows, written n times. Blank cells, bars and borders are mostly runs like this
+//      10nnnnnn    n instruction bytes follow
+struct LCD_Asset_Format {
+    constexpr static uint8_t DATA_RUN = 0x00;
+    constexpr static uint8_t REPEAT_RUN = 0x40;
+    constexpr static uint8_t INSTRUCTION_RUN = 0x80;
+    constexpr static uint8_t KIND_MASK = 0xC0;
+    constexpr static uint8_t MAX_RUN = 0x3F;
+    constexpr static uint8_t MIN_REPEAT = 3;        // a repeat run of two takes the same two bytes as writing both out
+};
+
+// What a screen should look like once it has been drawn. Everything here only ever runs in the compiler
+class LCD_Screen {
+    public:
+        constexpr static uint8_t COLUMNS = 16;
+        constexpr static uint8_t ROWS = 2;
+        constexpr static uint8_t GLYPHS = 8;        // custom characters, 0-7
+
+        enum Cursor: uint8_t {
+            cursor_hidden       = 0b000,
+            cursor_underline    = 0b010,
+            cursor_blink        = 0b001,            // the whole cell flashes
+            cursor_both         = 0b011,
+        };
+
+        constexpr LCD_Screen(void) : _cells{}, _glyphs{}, _glyph_defined{} {
+            for (auto &row : _cells) {
+                for (uint8_t &cell : row) cell = ' ';
+            }
+        }
+
+        // Anything that doesn't fit on the row is cut off
+        constexpr LCD_Screen &text(uint8_t column, uint8_t row, const char *text) {
+            for (; *text && column < COLUMNS; column++) {
+                _cells[row & 1][column] = *text++;
+            }
+            return *this;
+        }
+
+        // A single character by its code, for custom characters and anything else a string literal can't easily hold
+        constexpr LCD_Screen &character(uint8_t column, uint8_t row, uint8_t code) {
+            if (column < COLUMNS) _cells[row & 1][column] = code;
+            return *this;
+        }
+
+        // A custom character, top row first, 5 pixels per row in the low bits
+        constexpr LCD_Screen &glyph(uint8_t code, const uint8_t (&rows)[8]) {
+            for (uint8_t row = 0; row < 8; row++) {
+                _glyphs[code & 7][row] = rows[row] & 0x1F;
+            }
+            _glyph_defined[code & 7] = true;
+            return *this;
+        }
+
+        constexpr LCD_Screen &cursor(uint8_t column, uint8_t row, Cursor style = cursor_underline) {
+            _cursor_address = (row & 1) * _SECOND_LINE_ADDRESS + column;
+            _cursor_style = style;
+            return *this;
+        }
+
+        // The screen is drawn with the display off, eg to have it ready before turning the backlight on
+        constexpr LCD_Screen &display_off(void) {
+            _display_on = false;
+            return *this;
+        }
+
+        // The bus transactions that draw the screen, packed the way LCD_Asset keeps them. Pass nullptr to only count the bytes
+        template <typename Timing = HD44780_Timing>
+        constexpr uint16_t compile(uint8_t *bytes, uint16_t *transactions = nullptr, uint32_t *draw_time_us = nullptr) const {
+            Transactions screen = all_transactions();
+            if (transactions) *transactions = screen.count;
+            if (draw_time_us) *draw_time_us = screen.time_us<Timing>();
+            return screen.encode(bytes);
+        }
+
+    private:
+        constexpr static uint8_t _SECOND_LINE_ADDRESS = 0x40;
+        constexpr static uint8_t _INSTR_DISPLAY_CONTROL = 0x08;     // OR in 0x04 for display on, and a Cursor
+        constexpr static uint8_t _INSTR_SET_CGRAM_ADDR = 0x40;
+        constexpr static uint8_t _INSTR_SET_DDRAM_ADDR = 0x80;
+
+        uint8_t _cells[ROWS][COLUMNS];
+        uint8_t _glyphs[GLYPHS][8];
+        bool _glyph_defined[GLYPHS];
+        uint8_t _cursor_address = 0;
+        Cursor _cursor_style = cursor_hidden;
+        bool _display_on = true;
+
+        // Every write the screen takes, unpacked: the glyphs, both rows and the display settings
+        struct Transactions {
+            constexpr static uint16_t MAX = GLYPHS * 9 + ROWS * (1 + COLUMNS) + 2;
+
+            uint8_t values[MAX] = {};
+            bool register_select[MAX] = {};
+            uint16_t count = 0;
+
+            constexpr void add(uint8_t value, bool data) {
+                values[count] = value;
+                register_select[count] = data;
+                count++;
+            }
+
+            template <typename Timing>
+            constexpr uint32_t time_us(void) const {
+                uint32_t time_us = 0;
+                for (uint16_t i = 0; i < count; i++) {
+                    time_us += register_select[i] ? Timing::DATA_WRITE_US : Timing::INSTRUCTION_US;     // nothing here clears or returns home
+                }
+                return time_us;
+            }
+
+            constexpr uint16_t encode(uint8_t *bytes) const {
+                uint16_t size = 0;
+                uint16_t i = 0;
+                while (i < count) {
+                    uint8_t kind = LCD_Asset_Format::INSTRUCTION_RUN;
+                    uint16_t length = 1;
+
+                    if (register_select[i]) {
+                        length = repeats(i);
+                        kind = length >= LCD_Asset_Format::MIN_REPEAT ? LCD_Asset_Format::REPEAT_RUN : LCD_Asset_Format::DATA_RUN;
+                    }
+                    if (kind == LCD_Asset_Format::DATA_RUN) {
+                        // Up to where the data stops, or a repeat starts that is worth a run of its own
+                        length = 0;
+                        while (i + length < count && register_select[i + length] && length < LCD_Asset_Format::MAX_RUN
+                                && repeats(i + length) < LCD_Asset_Format::MIN_REPEAT) {
+                            length++;
+                        }
+                    }
+                    else if (kind == LCD_Asset_Format::INSTRUCTION_RUN) {
+                        while (i + length < count && !register_select[i + length] && length < LCD_Asset_Format::MAX_RUN) {
+                            length++;
+                        }
+                    }
+
+                    if (bytes) bytes[size] = kind | length;
+                    size++;
+                    uint16_t payload = kind == LCD_Asset_Format::REPEAT_RUN ? 1 : length;
+                    for (uint16_t j = 0; j < payload; j++) {
+                        if (bytes) bytes[size] = values[i + j];
+                        size++;
+                    }
+                    i += length;
+                }
+                return size;
+            }
+
+            // How many data writes of the same value start here, as far as one run can hold
+            constexpr uint16_t repeats(uint16_t start) const {
+                uint16_t length = 1;
+                while (start + length < count && register_select[start + length] && values[start + length] == values[start]
+                        && length < LCD_Asset_Format::MAX_RUN) {
+                    length++;
+                }
+                return length;
+            }
+        };
+
+        // Every cell is written, blank or not, so whatever the last screen left behind is covered. A clear would save sending the
+        // blanks, but on its own it takes as long as 37 character writes, longer than writing all 32 cells. This does assume the
+        // display isn't shifted, eg by a marquee, because only a clear or return home undoes that
+        constexpr Transactions all_transactions(void) const {
+            Transactions transactions;
+
+            for (uint8_t code = 0; code < GLYPHS; code++) {
+                if (!_glyph_defined[code]) continue;
+                transactions.add(_INSTR_SET_CGRAM_ADDR | (code << 3), false);
+                for (uint8_t row = 0; row < 8; row++) {
+                    transactions.add(_glyphs[code][row], true);
+                }
+            }
+
+            for (uint8_t row = 0; row < ROWS; row++) {
+                transactions.add(_INSTR_SET_DDRAM_ADDR | (row * _SECOND_LINE_ADDRESS), false);
+                for (uint8_t column = 0; column < COLUMNS; column++) {
+                    transactions.add(_cells[row][column], true);
+                }
+            }
+
+            transactions.add(_INSTR_DISPLAY_CONTROL | (_display_on ? 0x04 : 0) | _cursor_style, false);
+            if (_cursor_style != cursor_hidden) {
+                transactions.add(_INSTR_SET_DDRAM_ADDR | _cursor_address, false);
+            }
+            return transactions;
+        }
+};
+
+template <uint16_t SIZE_, typename Timing = HD44780_Timing>
+class LCD_Asset {
+    public:
+        constexpr LCD_Asset(const LCD_Screen &screen) : _bytes{}, _transactions(0), _draw_time_us(0) {
+            screen.compile<Timing>(_bytes, &_transactions, &_draw_time_us);
+        }
+
+        constexpr static uint16_t size(void) { return SIZE_; }                          // bytes of flash
+        constexpr uint16_t transactions(void) const { return _transactions; }           // writes to the display
+        constexpr uint32_t draw_time_us(void) const { return _draw_time_us; }           // the display's execution time, the bus adds a little on top
+
+        // Hands each write to the display in turn, reading the asset straight out of flash. Used by LCD_Display::play()
+        template <typename Write>
+        void replay(Write write) const {
+            uint16_t i = 0;
+            while (i < SIZE_) {
+                uint8_t tag = read(i++);
+                uint8_t length = tag & LCD_Asset_Format::MAX_RUN;
+                uint8_t kind = tag & LCD_Asset_Format::KIND_MASK;
+
+                if (kind == LCD_Asset_Format::REPEAT_RUN) {
+                    uint8_t value = read(i++);
+                    for (uint8_t j = 0; j < length; j++) {
+                        write(value, true);
+                    }
+                    continue;
+                }
+                for (uint8_t j = 0; j < length; j++) {
+                    write(read(i++), kind == LCD_Asset_Format::DATA_RUN);
+                }
+            }
+        }
+
+    private:
+        uint8_t _bytes[SIZE_];
+        uint16_t _transactions;
+        uint32_t _draw_time_us;
+
+        uint8_t read(uint16_t i) const {
+#if defined(__AVR__)
+            return pgm_read_byte(&_bytes[i]);
+#else
+            return _bytes[i];
+#endif
+        }
+};
+
+// Turns a function that describes a screen into an asset exactly the size it needs. The function has to be constexpr, a lambda
+// with no captures is the easy way
+template <typename Timing = HD44780_Timing, typename Define>
+constexpr auto lcd_asset(Define define) {
+    constexpr LCD_Screen screen = define();
+    return LCD_Asset<screen.compile<Timing>(nullptr), Timing>(screen);
+}
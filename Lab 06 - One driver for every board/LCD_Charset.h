@@ -0,0 +1,372 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#endif
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+// print_text() sends bytes, and the display looks each one up in its character ROM. Below 0x80 both ROMs are mostly ASCII, but
+// our source files are UTF-8, so "21°C" arrives as '2', '1', 0xC2, 0xB0, 'C' and shows two characters of garbage where the degree
+// sign should be. The display has a degree sign, and µ, Ω, arrows and katakana too, just not where UTF-8 puts them, and which ones
+// depends on the ROM the controller was made with:
+//      A00     Japanese. ASCII, except ¥ where the backslash would be and arrows in place of ~ and DEL, then half width katakana
+//              and a row of Greek letters and symbols
+//      A02     European. All of ASCII, most of Latin-1 in the top half, and arrows and brackets in 0x10-0x1F
+//
+// An LCD_Charset turns UTF-8 into the codes of one ROM. Characters the ROM doesn't have come out as '?', unless they are given a
+// custom character of their own. Up to eight fit in CGRAM, and load_glyphs() puts them there:
+//
+//      constexpr LCD_Glyph EURO = {0x20AC, {0b00110, 0b01001, 0b11100, 0b01000, 0b11100, 0b01001, 0b00110, 0b00000}};
+//      constexpr LCD_Charset<rom_a00, 1> MY_CHARSET PROGMEM = LCD_Charset<rom_a00, 1>({EURO});
+//
+// The PROGMEM isn't optional. On an AVR, transcode() and load_glyphs() read the charset with pgm_read_byte(), so a charset left
+// in RAM gives them garbage. It wouldn't fit in an Uno's RAM anyway, the tables are a few kilobytes. Everywhere else it means nothing
+//
+// Text known when the program is written is transcoded by the compiler, with a literal:
+//      constexpr auto TEMPERATURE = "21°C"_a00;                  // or _a02, or MY_CHARSET.literal("5€") for the custom characters
+//      my_lcd_screen->print_text(TEMPERATURE.data(), TEMPERATURE.length());
+// Declared constexpr like this, none of the work below happens on the board, and the tables don't even end up in flash.
+//
+// Text put together at run time goes through transcode(), which does the same work from the same tables. Each byte is one lookup
+// of its UTF-8 class, one state transition and one two level lookup of the character, whatever it turns out to be. No chain of
+// ifs for ASCII, two byte, three byte and so on, the state machine knows where it is in a sequence and the result is only kept
+// when it is at the end of one. A broken sequence comes out as a single '?', and the byte that showed it was broken goes with it.
+
+enum LCD_Rom: uint8_t {
+    rom_a00,
+    rom_a02,
+};
+
+// A custom character for a code point the ROM doesn't have. Top row first, 5 pixels per row in the low bits
+struct LCD_Glyph {
+    uint32_t code_point;
+    uint8_t rows[8];
+};
+
+// Transcoded text, ready for print_text(). CGRAM characters are codes 0-7, so it can hold a 0 and isn't NUL terminated
+template <uint8_t CAPACITY = 40>
+class LCD_Text {
+    public:
+        constexpr LCD_Text(void) : _codes{}, _length(0) {}
+
+        const char *data(void) const { return _codes; }
+        constexpr uint8_t length(void) const { return _length; }
+        constexpr uint8_t operator[](uint8_t i) const { return _codes[i]; }
+
+    private:
+        template <LCD_Rom, uint8_t> friend class LCD_Charset;
+
+        // One spare, a katakana with a voicing mark takes two codes and both are always written. If the mark lands in the spare
+        // it is left out of length(), so the last cell shows the katakana without it
+        char _codes[CAPACITY + 1];
+        uint8_t _length;
+};
+
+// Hoehrmann's UTF-8 decoder. Each byte has a class, and the class and the current state give the next state. States are
+// multiples of 12, so they index the transition table directly
+constexpr uint8_t LCD_UTF8_ACCEPT = 0;
+constexpr uint8_t LCD_UTF8_REJECT = 12;
+
+inline constexpr uint8_t LCD_UTF8_CLASSES[256] PROGMEM = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    8, 8, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    10, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 4, 3, 3, 11, 6, 6, 6, 5, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+};
+
+inline constexpr uint8_t LCD_UTF8_TRANSITIONS[108] PROGMEM = {
+    0, 12, 24, 36, 60, 96, 84, 12, 12, 12, 48, 72,  12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 0, 12, 12, 12, 12, 12, 0, 12, 0, 12, 12,    12, 24, 12, 12, 12, 12, 12, 24, 12, 24, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 24, 12, 12, 12, 12, 12, 24, 12, 12, 12, 12, 12, 12, 12, 24, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 36, 12, 36, 12, 12, 12, 36, 12, 12, 12, 12, 12, 36, 12, 36, 12, 12,
+    12, 36, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+};
+
+// Everything a ROM has, as code point, character code, and for katakana with a voicing mark, the mark that goes in the next cell
+template <typename Map>
+constexpr void lcd_rom_characters(LCD_Rom rom, Map map) {
+    if (rom == rom_a00) {
+        for (uint32_t code_point = 0x20; code_point <= 0x7D; code_point++) {
+            if (code_point != '\\') map(code_point, code_point, 0);
+        }
+        map(0x00A5, 0x5C, 0);       // ¥
+        map(0x2192, 0x7E, 0);       // →
+        map(0x2190, 0x7F, 0);       // ←
+
+        // Half width katakana are in the same order as the ROM, full width ones are mapped onto them
+        for (uint32_t code_point = 0xFF61; code_point <= 0xFF9F; code_point++) {
+            map(code_point, 0xA1 + (code_point - 0xFF61), 0);
+        }
+        map(0x3002, 0xA1, 0);       // 。
+        map(0x300C, 0xA2, 0);       // 「
+        map(0x300D, 0xA3, 0);       // 」
+        map(0x3001, 0xA4, 0);       // 、
+        map(0x30FB, 0xA5, 0);       // ・
+        map(0x30FC, 0xB0, 0);       // ー
+        map(0x309B, 0xDE, 0);       // ゛
+        map(0x309C, 0xDF, 0);       // ゜
+
+        constexpr uint8_t VOICED = 0xDE, SEMI_VOICED = 0xDF;
+        for (uint8_t i = 0; i < 5; i++) {           // ァア ィイ ゥウ ェエ ォオ
+            map(0x30A1 + i * 2, 0xA7 + i, 0);
+            map(0x30A2 + i * 2, 0xB1 + i, 0);
+        }
+        for (uint8_t i = 0; i < 12; i++) {          // カガ to チヂ
+            map(0x30AB + i * 2, 0xB6 + i, 0);
+            map(0x30AC + i * 2, 0xB6 + i, VOICED);
+        }
+        map(0x30C3, 0xAF, 0);                       // ッ
+        for (uint8_t i = 0; i < 3; i++) {           // ツヅ テデ トド
+            map(0x30C4 + i * 2, 0xC2 + i, 0);
+            map(0x30C5 + i * 2, 0xC2 + i, VOICED);
+        }
+        for (uint8_t i = 0; i < 5; i++) {           // ナ to ノ
+            map(0x30CA + i, 0xC5 + i, 0);
+        }
+        for (uint8_t i = 0; i < 5; i++) {           // ハバパ to ホボポ
+            map(0x30CF + i * 3, 0xCA + i, 0);
+            map(0x30D0 + i * 3, 0xCA + i, VOICED);
+            map(0x30D1 + i * 3, 0xCA + i, SEMI_VOICED);
+        }
+        for (uint8_t i = 0; i < 5; i++) {           // マ to モ
+            map(0x30DE + i, 0xCF + i, 0);
+        }
+        for (uint8_t i = 0; i < 3; i++) {           // ャヤ ュユ ョヨ
+            map(0x30E3 + i * 2, 0xAC + i, 0);
+            map(0x30E4 + i * 2, 0xD4 + i, 0);
+        }
+        for (uint8_t i = 0; i < 5; i++) {           // ラ to ロ
+            map(0x30E9 + i, 0xD7 + i, 0);
+        }
+        map(0x30EF, 0xDC, 0);                       // ワ
+        map(0x30F2, 0xA6, 0);                       // ヲ
+        map(0x30F3, 0xDD, 0);                       // ン
+        map(0x30F4, 0xB3, VOICED);                  // ヴ
+
+        // The last two rows
+        map(0x03B1, 0xE0, 0);       // α
+        map(0x00E4, 0xE1, 0);       // ä
+        map(0x03B2, 0xE2, 0);       // β
+        map(0x03B5, 0xE3, 0);       // ε
+        map(0x03BC, 0xE4, 0);       // μ
+        map(0x00B5, 0xE4, 0);       // µ, the micro sign
+        map(0x03C3, 0xE5, 0);       // σ
+        map(0x03C1, 0xE6, 0);       // ρ
+        map(0x221A, 0xE8, 0);       // √
+        map(0x00A2, 0xEC, 0);       // ¢
+        map(0x00A3, 0xED, 0);       // £
+        map(0x00F1, 0xEE, 0);       // ñ
+        map(0x00F6, 0xEF, 0);       // ö
+        map(0x03B8, 0xF2, 0);       // θ
+        map(0x221E, 0xF3, 0);       // ∞
+        map(0x03A9, 0xF4, 0);       // Ω
+        map(0x2126, 0xF4, 0);       // Ω, the ohm sign
+        map(0x00FC, 0xF5, 0);       // ü
+        map(0x03A3, 0xF6, 0);       // Σ
+        map(0x03C0, 0xF7, 0);       // π
+        map(0x5343, 0xFA, 0);       // 千
+        map(0x4E07, 0xFB, 0);       // 万
+        map(0x5186, 0xFC, 0);       // 円
+        map(0x00F7, 0xFD, 0);       // ÷
+        map(0x2588, 0xFF, 0);       // █
+        map(0x00B0, 0xDF, 0);       // there is no degree sign, but the semi voiced mark is a small circle in the same place
+    }
+    else {
+        for (uint32_t code_point = 0x20; code_point <= 0x7E; code_point++) {
+            map(code_point, code_point, 0);
+        }
+        map(0x2302, 0x7F, 0);       // ⌂
+        map(0x25B6, 0x10, 0);       // ▶
+        map(0x25C0, 0x11, 0);       // ◀
+        map(0x201C, 0x12, 0);       // “
+        map(0x201D, 0x13, 0);       // ”
+        map(0x2191, 0x18, 0);       // ↑
+        map(0x2193, 0x19, 0);       // ↓
+        map(0x2192, 0x1A, 0);       // →
+        map(0x2190, 0x1B, 0);       // ←
+        map(0x2264, 0x1C, 0);       // ≤
+        map(0x2265, 0x1D, 0);       // ≥
+        map(0x25B2, 0x1E, 0);       // ▲
+        map(0x25BC, 0x1F, 0);       // ▼
+
+        // The top half is Latin-1, apart from three cells where A02 has something else
+        for (uint32_t code_point = 0xA0; code_point <= 0xFF; code_point++) {
+            if (code_point != 0xA8 && code_point != 0xB4 && code_point != 0xB8) map(code_point, code_point, 0);
+        }
+    }
+}
+
+// Code points are looked up 64 at a time, a page. Only the pages a ROM has something on are stored
+constexpr uint8_t lcd_rom_page_count(LCD_Rom rom) {
+    bool used[0x10000 >> 6] = {};
+    uint8_t count = 0;
+    lcd_rom_characters(rom, [&](uint32_t code_point, uint8_t, uint8_t) {
+        if (!used[code_point >> 6]) {
+            used[code_point >> 6] = true;
+            count++;
+        }
+    });
+    return count;
+}
+
+template <LCD_Rom ROM, uint8_t FALLBACKS = 0>
+class LCD_Charset {
+    public:
+        static_assert(FALLBACKS <= 8, "there are only 8 custom characters");
+
+        constexpr static uint8_t REPLACEMENT = '?';
+
+        constexpr LCD_Charset(void) : _page_of{}, _pages{}, _glyphs{}, _page_count(1) {
+            static_assert(FALLBACKS == 0, "pass in the custom characters");
+            build();
+        }
+
+        template <size_t COUNT>
+        constexpr LCD_Charset(const LCD_Glyph (&glyphs)[COUNT]) : _page_of{}, _pages{}, _glyphs{}, _page_count(1) {
+            static_assert(COUNT == FALLBACKS, "one glyph for each custom character");
+            for (uint8_t i = 0; i < COUNT; i++) {
+                _glyphs[i] = glyphs[i];
+            }
+            build();
+        }
+
+        // For text known at compile time. Declare the result constexpr and the compiler does all the work
+        template <uint8_t CAPACITY = 40>
+        constexpr LCD_Text<CAPACITY> literal(const char *utf8, size_t length) const {
+            LCD_Text<CAPACITY> text;
+            Decoder decoder;
+            for (size_t i = 0; i < length && text._length < CAPACITY; i++) {
+                step<false>(text, decoder, utf8[i]);
+            }
+            return finish(text);
+        }
+
+        template <uint8_t CAPACITY = 40, size_t SIZE>
+        constexpr LCD_Text<CAPACITY> literal(const char (&utf8)[SIZE]) const {
+            return literal<CAPACITY>(utf8, SIZE - 1);
+        }
+
+        // For text put together at run time, up to its terminating NUL. The charset has to be declared PROGMEM, see the top of the file
+        template <uint8_t CAPACITY = 40>
+        LCD_Text<CAPACITY> transcode(const char *utf8) const {
+            LCD_Text<CAPACITY> text;
+            Decoder decoder;
+            for (; *utf8 && text._length < CAPACITY; utf8++) {
+                step<true>(text, decoder, *utf8);
+            }
+            return finish(text);
+        }
+
+        // Puts the custom characters into the display's CGRAM. Once at startup is enough, they stay until the power goes. Reads them
+        // out of flash like transcode() does
+        template <typename Display>
+        void load_glyphs(Display &display) const {
+            for (uint8_t code = 0; code < FALLBACKS; code++) {
+                uint8_t rows[8];
+                for (uint8_t row = 0; row < 8; row++) {
+                    rows[row] = read<true>(_glyphs[code].rows[row]);
+                }
+                display.define_character(code, rows);
+            }
+        }
+
+    private:
+        constexpr static uint16_t _PAGE_INDEX_SIZE = 0x10000 >> 6;     // the whole Basic Multilingual Plane
+
+        // Page 0 is every code point the ROM hasn't got, and a custom character might need a page of its own
+        constexpr static uint8_t _PAGES = 1 + lcd_rom_page_count(ROM) + FALLBACKS;
+
+        // Where the decoder has got to. A UTF-8 sequence is up to four bytes, and the code point is built up a byte at a time
+        struct Decoder {
+            uint8_t state = LCD_UTF8_ACCEPT;
+            uint32_t code_point = 0;
+        };
+
+        uint8_t _page_of[_PAGE_INDEX_SIZE];
+        uint16_t _pages[_PAGES][64];        // the character code in the low byte, and a second code for a voicing mark or 0 in the high
+        LCD_Glyph _glyphs[FALLBACKS > 0 ? FALLBACKS : 1];
+        uint8_t _page_count;
+
+        constexpr void build(void) {
+            for (uint16_t &entry : _pages[0]) entry = REPLACEMENT;
+            lcd_rom_characters(ROM, [this](uint32_t code_point, uint8_t code, uint8_t mark) {
+                map(code_point, code, mark);
+            });
+
+            // The ROM comes first, so a custom character is only used for something it really doesn't have
+            for (uint8_t code = 0; code < FALLBACKS; code++) {
+                uint32_t code_point = _glyphs[code].code_point;
+                if (code_point <= 0xFFFF && _pages[_page_of[code_point >> 6]][code_point & 0x3F] == REPLACEMENT && code_point != REPLACEMENT) {
+                    map(code_point, code, 0);
+                }
+            }
+        }
+
+        constexpr void map(uint32_t code_point, uint8_t code, uint8_t mark) {
+            uint8_t &page = _page_of[code_point >> 6];
+            if (page == 0) {
+                page = _page_count++;
+                for (uint16_t &entry : _pages[page]) entry = REPLACEMENT;
+            }
+            _pages[page][code_point & 0x3F] = code | (uint16_t(mark) << 8);
+        }
+
+        template <bool FROM_FLASH, typename T>
+        constexpr static T read(const T &value) {
+#if defined(__AVR__)
+            if constexpr (FROM_FLASH) {
+                if constexpr (sizeof(T) == 1) return pgm_read_byte(&value);
+                else return pgm_read_word(&value);
+            }
+#endif
+            return value;
+        }
+
+        // One byte of UTF-8. Each line is the same few instructions whatever the byte is, the selects turn into masks and
+        // conditional moves rather than jumps
+        template <bool FROM_FLASH, uint8_t CAPACITY>
+        constexpr void step(LCD_Text<CAPACITY> &text, Decoder &decoder, char character) const {
+            uint8_t byte = character;
+            uint8_t type = read<FROM_FLASH>(LCD_UTF8_CLASSES[byte]);
+            uint32_t continuing = -uint32_t(decoder.state != LCD_UTF8_ACCEPT);
+            decoder.code_point = (continuing & ((byte & 0x3F) | (decoder.code_point << 6))) | (~continuing & ((0xFF >> type) & byte));
+            decoder.state = read<FROM_FLASH>(LCD_UTF8_TRANSITIONS[decoder.state + type]);
+
+            // Mid sequence this looks up a code point that isn't finished yet, and the result is thrown away
+            uint32_t in_plane = decoder.code_point <= 0xFFFF;
+            uint8_t page = read<FROM_FLASH>(_page_of[(decoder.code_point >> 6) & (_PAGE_INDEX_SIZE - 1)]) * in_plane;
+            uint16_t entry = read<FROM_FLASH>(_pages[page][decoder.code_point & 0x3F]);
+
+            uint8_t finished = decoder.state == LCD_UTF8_ACCEPT;
+            uint8_t broken = decoder.state == LCD_UTF8_REJECT;
+            uint16_t keep = -uint16_t(broken);
+            entry = (keep & REPLACEMENT) | (~keep & entry);
+
+            text._codes[text._length] = entry & 0xFF;
+            text._codes[text._length + 1] = entry >> 8;
+            text._length += (finished | broken) * (1 + (entry > 0xFF));
+            decoder.state *= !broken;
+        }
+
+        template <uint8_t CAPACITY>
+        constexpr static LCD_Text<CAPACITY> finish(LCD_Text<CAPACITY> &text) {
+            if (text._length > CAPACITY) text._length = CAPACITY;      // a voicing mark that didn't fit is dropped
+            return text;
+        }
+};
+
+// The two ROMs as they come, for the literals. Only ever put in flash if transcode() is used on them at run time
+inline constexpr LCD_Charset<rom_a00> LCD_ROM_A00 PROGMEM = LCD_Charset<rom_a00>();
+inline constexpr LCD_Charset<rom_a02> LCD_ROM_A02 PROGMEM = LCD_Charset<rom_a02>();
+
+constexpr LCD_Text<> operator""_a00(const char *utf8, size_t length) { return LCD_ROM_A00.literal(utf8, length); }
+constexpr LCD_Text<> operator""_a02(const char *utf8, size_t length) { return LCD_ROM_A02.literal(utf8, length); }
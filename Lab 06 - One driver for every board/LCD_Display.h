@@ -0,0 +1,256 @@
+#pragma once
+
+#include <stdint.h>
+
+// The HD44780 driver, written once for every board. So far each lab has had its own copy: free functions in Lab 01,
+// digitalWrite() in Lab 02, DigitalOut and BusOut in Lab 03, port registers in Lab 04, and each copy ended up making
+// its own choices about timing. Here everything that touches the hardware goes through a HAL (hardware abstraction layer),
+// passed in as a template parameter. The HAL is a struct of static functions, so every call to it is resolved at compile
+// time and inlined, exactly as if we had written the register accesses into the driver ourselves. No virtual functions,
+// no function pointers and nothing stored per display.
+//
+// A HAL provides:
+//      constexpr static bool HAS_READ_WRITE                RW is wired up, so the busy flag can be read
+//      constexpr static uint32_t NOW_RESOLUTION_US         how far now_us() can lag behind the real time
+//      static void begin(void)                             set every pin up: E, RS and RW LOW, the bus driving LOW
+//      static void write_register_select(bool level)
+//      static void write_read_write(bool level)            only called when HAS_READ_WRITE
+//      static void write_enable(bool level)
+//      static void write_bus(uint8_t value)                all eight data lines, DB0 in bit 0
+//      static uint8_t read_bus(void)
+//      static void release_bus(void)                       let the display drive the bus, DB7 pulled up so nobody answering reads as busy
+//      static void take_bus(void)                          drive the bus ourselves again
+//      static void delay_ns(uint32_t ns)                   at least this long. Always called with a constant, so it can fold into an exact cycle count
+//      static uint32_t now_us(void)                        a free running microsecond count, allowed to wrap
+
+// Device timings from the datasheet. Execution times are for fosc = 270kHz (Table 6), bus timings are from Figure 25.
+// Pass a different profile in as the second template parameter for a controller that runs slower, or a bus with long wires
+struct HD44780_Timing {
+    constexpr static uint32_t CLEAR_US = 1520;              // clear display and return home
+    constexpr static uint32_t INSTRUCTION_US = 37;          // everything else
+    constexpr static uint32_t DATA_WRITE_US = 37 + 4;       // writing data takes 37us, then tADD of 4us before the address counter moves
+    constexpr static uint32_t ADDRESS_SETUP_NS = 40;        // tAS, RS and RW must settle before E rises
+    constexpr static uint32_t ENABLE_PULSE_NS = 230;        // PWEH, E must stay HIGH this long. Also covers tDDR (160ns) on a read
+    constexpr static uint32_t DATA_HOLD_NS = 10;            // tH, the bus must not change straight after E falls
+    constexpr static uint32_t ENABLE_CYCLE_NS = 500;        // tcycE, from one rising edge of E to the next
+};
+
+template <typename HAL, typename Timing = HD44780_Timing>
+class LCD_Display {
+    public:
+        LCD_Display(void) {
+            HAL::begin();
+
+            // Initialise the display. Each write waits for the one before it, so there is no need to sleep after the clear
+            write_byte(instr_fn_set, false);
+            write_byte(instr_display_on_no_cursor_blink, false);
+            write_byte(instr_entry_mode, false);
+            write_byte(instr_clear_disp, false);    // Clear the display (This also resets cursor position)
+        }
+
+        void print_text(const char *text) {
+            while (*text) {
+                write_byte(*text++, true);
+            }
+        }
+
+        void print_text(const char *text, uint8_t length) {
+            for (uint8_t i = 0; i < length; i++) {
+                write_byte(text[i], true);
+            }
+        }
+
+        void set_cursor(uint8_t column, uint8_t row) {
+            write_byte(instr_set_ddram_addr | ((row & 1) * _SECOND_LINE_ADDRESS + column), false);
+        }
+
+        // Scrolls both rows from right to left, one column each time marquee_step() is called. Each row's text goes round and round,
+        // so put a few spaces on the end to keep the end of it apart from the start. An empty row is still blanked here, but costs
+        // nothing per step. The texts are not copied, so they must stay put. Everything on screen is part of the marquee until it is started again
+        void start_marquee(const char *top, const char *bottom = "") {
+            const char *texts[2] = {top, bottom};
+            write_byte(instr_return_home, false);      // undoes the shift left over from the last marquee
+            _marquee_column = 0;
+
+            // Fill all 40 columns of both lines, the 16 on screen and the 24 waiting off to the right of it
+            for (uint8_t row = 0; row < 2; row++) {
+                _marquee_text[row] = texts[row];
+                _marquee_length[row] = 0;
+                while (texts[row][_marquee_length[row]] && _marquee_length[row] < 0xFF) {
+                    _marquee_length[row]++;
+                }
+                _marquee_next[row] = 0;
+
+                set_address(row * _SECOND_LINE_ADDRESS);
+                for (uint8_t column = 0; column < _DDRAM_LINE_LENGTH; column++) {
+                    write_byte(next_marquee_character(row), true);
+                }
+            }
+        }
+
+        // One shift instruction moves everything, then the column that has just gone off the left edge is refilled with what will
+        // come on at the right 24 steps from now. One or two writes per row however wide the display is, rather than the whole line
+        void marquee_step(void) {
+            write_byte(instr_shift_display_left, false);
+            for (uint8_t row = 0; row < 2; row++) {
+                if (_marquee_length[row] == 0) continue;
+                set_address(row * _SECOND_LINE_ADDRESS + _marquee_column);
+                write_byte(next_marquee_character(row), true);
+            }
+            _marquee_column = (_marquee_column + 1) % _DDRAM_LINE_LENGTH;
+        }
+
+        // Puts a custom character into CGRAM as code 0-7, top row first, 5 pixels per row in the low bits. Writing CGRAM moves the
+        // address counter there, so it is put back afterwards and whatever is printed next still goes where it would have
+        void define_character(uint8_t code, const uint8_t rows[8]) {
+            uint8_t address = _address_counter;
+            write_byte(instr_set_cgram_addr | ((code & 7) << 3), false);
+            for (uint8_t row = 0; row < 8; row++) {
+                write_byte(rows[row] & 0x1F, true);
+            }
+            write_byte(instr_set_ddram_addr | address, false);
+        }
+
+        // Draws a screen compiled into flash by LCD_Asset.h. Each byte is read out of flash and straight onto the bus, nothing
+        // is put together in RAM first
+        template <typename Asset>
+        void play(const Asset &asset) {
+            asset.replay([this](uint8_t value, bool register_select) {
+                write_byte(value, register_select);
+            });
+        }
+
+        bool busy_flag_mode(void) { return _busy_flag_mode; }  // false if we are timing every instruction instead
+        static uint32_t now_us(void) { return HAL::now_us(); }  // the board's microsecond clock, for anything built on top of the driver
+
+    private:
+        constexpr static uint32_t _PULSE_TIME_US = 1;           // pulse_enable() takes well under 1us from start to the falling edge
+        constexpr static uint32_t _BUSY_TIMEOUT_US = 3000;      // nothing takes longer than 1.53ms (2.16ms on a slow oscillator), so if we are still busy after this, nobody is answering
+        constexpr static uint8_t _DDRAM_LINE_LENGTH = 40;       // columns of DDRAM per line in two line mode, only the first 16 are on screen until the display is shifted
+        constexpr static uint8_t _SECOND_LINE_ADDRESS = 0x40;
+
+        bool _busy_flag_mode = HAL::HAS_READ_WRITE;     // true = poll the busy flag before every write, false = time every write from Timing
+        uint32_t _ready_at_us = 0;      // when the display will have finished the last thing we sent it, in timed mode
+        uint8_t _address_counter = 0;   // where the display's next character will go, so the marquee can skip setting it when it is already there
+
+        // The marquee. _marquee_column is how far the display has been shifted, which is also the DDRAM column that goes off screen next
+        const char *_marquee_text[2] = {"", ""};
+        uint8_t _marquee_length[2] = {0, 0};
+        uint8_t _marquee_next[2] = {0, 0};     // the character in each text that goes into the next column to be refilled
+        uint8_t _marquee_column = 0;
+
+        enum LCD_Instructions: uint8_t {
+            instr_clear_disp                    = 0b00000001, // 0x01 clears the display entirely.
+            instr_return_home                   = 0b00000010, // 0x02 returns the cursor to the home position
+            instr_display_on_no_cursor_blink    = 0b00001100, // 0x0F Display ON, Cursor Off, Cursor Not Blinking.
+            instr_entry_mode                    = 0b00000110, // 0x06 Entry Mode, Increment cursor position, No display shift. change to B00000100 to disable automatic cursor increment
+            instr_fn_set                        = 0b00111000, // 0x38 Function set, 8 bit mode, 2 lines, 5×8 font.
+            instr_shift_display_left            = 0b00011000, // 0x18 Shift the whole display one column left, DDRAM and the cursor stay where they are
+            instr_set_cgram_addr                = 0b01000000, // 0x40 Set CGRAM address, OR the address into the lower 6 bits. Custom character n starts at n * 8
+            instr_set_ddram_addr                = 0b10000000, // 0x80 Set DDRAM address, OR the address into the lower 7 bits
+        };
+
+        // Only for the marquee, which knows nothing else is writing to the display. Anything that drives the bus behind our back,
+        // like a waveform player, leaves _address_counter wrong
+        void set_address(uint8_t address) {
+            if (address != _address_counter) {
+                write_byte(instr_set_ddram_addr | address, false);
+            }
+        }
+
+        char next_marquee_character(uint8_t row) {
+            if (_marquee_length[row] == 0) return ' ';
+            char character = _marquee_text[row][_marquee_next[row]];
+            _marquee_next[row] = (_marquee_next[row] + 1) % _marquee_length[row];
+            return character;
+        }
+
+        // Follows the address counter the way the display moves it. Two line mode, always incrementing
+        void track_address_counter(uint8_t value, bool register_select) {
+            if (register_select) {
+                _address_counter = _address_counter == _DDRAM_LINE_LENGTH - 1 ? _SECOND_LINE_ADDRESS
+                    : _address_counter == _SECOND_LINE_ADDRESS + _DDRAM_LINE_LENGTH - 1 ? 0 : _address_counter + 1;
+            }
+            else if (value & instr_set_ddram_addr) {
+                _address_counter = value & 0x7F;
+            }
+            else if (value <= instr_return_home) {
+                _address_counter = 0;
+            }
+        }
+
+        static uint32_t execution_time_us(uint8_t instruction) {
+            return instruction <= instr_return_home ? Timing::CLEAR_US : Timing::INSTRUCTION_US;
+        }
+
+        static void pulse_enable(void) {
+            HAL::delay_ns(Timing::ADDRESS_SETUP_NS);
+            HAL::write_enable(true);
+            HAL::delay_ns(Timing::ENABLE_PULSE_NS);
+            HAL::write_enable(false);               // the falling edge is what latches the command
+
+            // Hold the bus for tH, and on a fast MCU don't let the next busy flag poll come round again before tcycE is up
+            constexpr uint32_t CYCLE_REMAINDER_NS = Timing::ENABLE_CYCLE_NS - Timing::ENABLE_PULSE_NS - Timing::ADDRESS_SETUP_NS;
+            HAL::delay_ns(CYCLE_REMAINDER_NS > Timing::DATA_HOLD_NS ? CYCLE_REMAINDER_NS : Timing::DATA_HOLD_NS);
+        }
+
+        void write_byte(uint8_t value, bool register_select) {
+            if constexpr (HAL::HAS_READ_WRITE) {
+                if (_busy_flag_mode) {
+                    wait_until_ready();
+                }
+            }
+
+            HAL::write_register_select(register_select);   // false = Instruction register selected, true = Data register selected
+            HAL::write_bus(value);
+            track_address_counter(value, register_select);
+
+            if (_busy_flag_mode) {
+                pulse_enable();
+                return;
+            }
+
+            // The display has been executing the last command while we set up this one, so we only wait for whatever time is left
+            uint32_t now_us;
+            do {
+                now_us = HAL::now_us();
+            } while ((int32_t)(now_us - _ready_at_us) < 0);
+
+            pulse_enable();
+
+            // E fell within one clock step of now_us, plus the pulse itself
+            _ready_at_us = now_us + HAL::NOW_RESOLUTION_US + _PULSE_TIME_US + (register_select ? Timing::DATA_WRITE_US : execution_time_us(value));
+        }
+
+        void wait_until_ready(void) {
+            // Hand the data bus over to the display. DB7 gets a pull up, so if nothing is driving it we read busy and eventually time out
+            HAL::release_bus();
+            HAL::write_register_select(false);      // the busy flag is read from the instruction register
+            HAL::write_read_write(true);            // false = Write mode, true = Read Mode
+
+            uint32_t started_us = HAL::now_us();
+            while (read_busy_flag()) {
+                if (HAL::now_us() - started_us > _BUSY_TIMEOUT_US) {
+                    // RW is probably tied to ground, and every poll has just strobed whatever was floating on the bus into the display.
+                    // Fall back to timed mode for good, and give that junk instruction as long as the slowest one takes to finish.
+                    _busy_flag_mode = false;
+                    _ready_at_us = HAL::now_us() + HAL::NOW_RESOLUTION_US + Timing::CLEAR_US;
+                    break;
+                }
+            }
+
+            // Take the data bus back. E is already LOW, so the display has let go of it
+            HAL::write_read_write(false);
+            HAL::take_bus();
+        }
+
+        static bool read_busy_flag(void) {
+            HAL::delay_ns(Timing::ADDRESS_SETUP_NS);
+            HAL::write_enable(true);                // the display drives the bus for as long as E is HIGH
+            HAL::delay_ns(Timing::ENABLE_PULSE_NS);
+            bool busy = HAL::read_bus() & 0x80;     // DB7 is the busy flag, DB0-DB6 hold the address counter
+            HAL::write_enable(false);
+            HAL::delay_ns(Timing::ENABLE_CYCLE_NS - Timing::ENABLE_PULSE_NS - Timing::ADDRESS_SETUP_NS);  // a fast MCU could poll again far sooner than the display allows
+            return busy;
+        }
+};
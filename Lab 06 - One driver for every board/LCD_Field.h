@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+
+// A number that lives at a fixed place on the screen, like an RPM, a temperature or a counter. Rewriting the whole number with
+// print_text() every time it changes sends every digit, and a String on the way there. A field remembers what it is showing,
+// formats the new value into a buffer of its own, and sends only the cells that changed: a set cursor and then the characters,
+// one run at a time.
+//
+// Values are shown right aligned in WIDTH cells, with a minus sign in front of negative ones and spaces to the left.
+// With decimals set the value is fixed point, so a field with 1 decimal shows 215 as 21.5. A value that doesn't fit fills the
+// field with '#', the same as a spreadsheet.
+//
+// Sensors can change far faster than anyone can read a display. Give the field a minimum interval and set() will only send
+// that often. Anything set in between is held, only the latest value is kept, and update() sends it once the interval is up.
+template <typename Display, uint8_t WIDTH>
+class LCD_Field {
+    public:
+        static_assert(WIDTH >= 1 && WIDTH <= 16, "a field has to fit on one row");
+
+        LCD_Field(Display &display, uint8_t column, uint8_t row, uint8_t decimals = 0, uint32_t min_interval_us = 0)
+            : _display(display), _column(column), _row(row), _decimals(decimals), _min_interval_us(min_interval_us)
+        {
+            for (char &cell : _shown) cell = '\0';     // matches nothing, so the first value goes out in full
+        }
+
+        void set(long value) {
+            _pending = value;
+            _has_pending = true;
+            update();
+        }
+
+        // Sends a value that the rate cap held back, once its time has come. Call it from loop(), it does nothing if there isn't one
+        void update(void) {
+            if (!_has_pending) return;
+
+            uint32_t now_us = Display::now_us();
+            if (_sent && now_us - _sent_at_us < _min_interval_us) return;
+
+            _sent = true;
+            _sent_at_us = now_us;
+            _has_pending = false;
+            show(_pending);
+        }
+
+        bool pending(void) const { return _has_pending; }      // true while a value is waiting for the rate cap
+
+    private:
+        Display &_display;
+        const uint8_t _column, _row, _decimals;
+        const uint32_t _min_interval_us;
+
+        char _shown[WIDTH];             // what the display has in our cells
+        long _pending = 0;
+        bool _has_pending = false;
+        bool _sent = false;
+        uint32_t _sent_at_us = 0;
+
+        // Fills cells from the right. Returns false if the value doesn't fit
+        bool format(long value, char cells[WIDTH]) {
+            unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+            int8_t cell = WIDTH - 1;
+
+            // At least one digit in front of the decimal point, so 5 with 2 decimals is 0.05
+            for (uint8_t digit = 0; magnitude > 0 || digit <= _decimals; digit++) {
+                if (digit == _decimals && _decimals > 0) {
+                    if (cell < 0) return false;
+                    cells[cell--] = '.';
+                }
+                if (cell < 0) return false;
+                cells[cell--] = '0' + magnitude % 10;
+                magnitude /= 10;
+            }
+            if (value < 0) {
+                if (cell < 0) return false;
+                cells[cell--] = '-';
+            }
+            while (cell >= 0) {
+                cells[cell--] = ' ';
+            }
+            return true;
+        }
+
+        void show(long value) {
+            char cells[WIDTH];
+            if (!format(value, cells)) {
+                for (char &cell : cells) cell = '#';
+            }
+
+            // Send each run of changed cells with one set cursor. A single unchanged cell between two runs costs the same to
+            // send again as a second set cursor, so it is sent along with them
+            uint8_t column = 0;
+            while (column < WIDTH) {
+                if (cells[column] == _shown[column]) {
+                    column++;
+                    continue;
+                }
+
+                uint8_t end = column + 1;
+                while (end < WIDTH && (cells[end] != _shown[end] || (end + 1 < WIDTH && cells[end + 1] != _shown[end + 1]))) {
+                    end++;
+                }
+
+                _display.set_cursor(_column + column, _row);
+                _display.print_text(cells + column, end - column);
+                for (; column < end; column++) {
+                    _shown[column] = cells[column];
+                }
+            }
+        }
+};
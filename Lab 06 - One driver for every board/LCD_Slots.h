@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// A part of the screen that one kind of content owns, eg the whole top line for a status message, or 5 cells for a reading
+struct LCD_Region {
+    uint8_t column, row, width;
+};
+
+// Lets any number of threads put content on the display without any of them waiting for it. Sharing the driver behind a mutex
+// works, but a thread that only wants to report a new reading ends up queued behind whoever is halfway through a line, and the
+// display is slow enough that this adds up. Here the screen is split into slots, each one a region, and a single renderer thread
+// is the only one that ever touches the driver.
+//
+// publish() copies the text into a buffer and swaps it in as the slot's latest content. If the renderer hadn't got round to the
+// content that was there before, it never will: it is superseded, and its buffer goes back to be used again. render() takes the
+// latest content of every slot that has any and writes it out. However fast the producers go, the display is written at most once
+// per slot per frame, and always with the newest content.
+//
+// Nothing here waits. The buffers that aren't in use are kept on a lock free stack, and each slot's latest content is one atomic
+// index, swapped in a single exchange. On a Cortex-M3 or M4 those are LDREX/STREX loops on a 32 bit word and an 8 bit one, and an
+// interrupt can publish too. Every buffer has exactly one owner at a time, the free stack, a slot, a producer filling it or the
+// renderer sending it, so a buffer is never read while it is being written.
+//
+// BUFFERS has to cover one per slot, one for the renderer and one for each producer that can be in publish() at the same time.
+// If they ever run out publish() drops the update and returns false, rather than wait for one to come free.
+template <typename Display, uint8_t SLOTS, uint8_t BUFFERS>
+class LCD_Slots {
+    public:
+        static_assert(SLOTS >= 1, "at least one slot");
+        static_assert(BUFFERS > SLOTS + 1 && BUFFERS < 0xFF, "a buffer for every slot and the renderer, plus some for the producers");
+
+        LCD_Slots(Display &display, const LCD_Region (&regions)[SLOTS]) : _display(display) {
+            for (uint8_t slot = 0; slot < SLOTS; slot++) {
+                _regions[slot] = regions[slot];
+                if (_regions[slot].width > _MAX_WIDTH) _regions[slot].width = _MAX_WIDTH;     // a region is never more than a row
+                _latest[slot].store(NO_BUFFER, std::memory_order_relaxed);
+            }
+            for (uint8_t buffer = 0; buffer < BUFFERS; buffer++) {
+                _next_free[buffer].store(buffer + 1 < BUFFERS ? buffer + 1 : NO_BUFFER, std::memory_order_relaxed);
+            }
+            _free.store(0, std::memory_order_release);
+        }
+
+        // Safe from any thread, and from interrupts. Text shorter than the region is padded with spaces, longer text is cut off.
+        // Returns false if there was no buffer free and the update was dropped
+        bool publish(uint8_t slot, const char *text) {
+            if (slot >= SLOTS) return false;
+
+            uint8_t buffer = take_free();
+            if (buffer == NO_BUFFER) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            char *cells = _buffers[buffer];
+            uint8_t width = _regions[slot].width;
+            uint8_t cell = 0;
+            for (; cell < width && text[cell]; cell++) {
+                cells[cell] = text[cell];
+            }
+            for (; cell < width; cell++) {
+                cells[cell] = ' ';
+            }
+
+            // Release, so the renderer sees the cells filled in once it sees the index
+            uint8_t superseded = _latest[slot].exchange(buffer, std::memory_order_acq_rel);
+            if (superseded != NO_BUFFER) {
+                give_free(superseded);
+                _superseded.fetch_add(1, std::memory_order_relaxed);
+            }
+            _published.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Only ever from the renderer thread, the one that owns the display. Writes every slot published since the last call and
+        // returns how many that was
+        uint8_t render(void) {
+            uint8_t rendered = 0;
+            for (uint8_t slot = 0; slot < SLOTS; slot++) {
+                uint8_t buffer = _latest[slot].exchange(NO_BUFFER, std::memory_order_acq_rel);
+                if (buffer == NO_BUFFER) continue;
+
+                const LCD_Region &region = _regions[slot];
+                _display.set_cursor(region.column, region.row);
+                _display.print_text(_buffers[buffer], region.width);
+                give_free(buffer);
+                rendered++;
+            }
+            _rendered.fetch_add(rendered, std::memory_order_relaxed);
+            return rendered;
+        }
+
+        // Every publish() ends up rendered, superseded or dropped. Once the producers have stopped and render() has run one last
+        // time, published() == rendered() + superseded()
+        uint32_t published(void) const { return _published.load(std::memory_order_relaxed); }
+        uint32_t rendered(void) const { return _rendered.load(std::memory_order_relaxed); }
+        uint32_t superseded(void) const { return _superseded.load(std::memory_order_relaxed); }
+        uint32_t dropped(void) const { return _dropped.load(std::memory_order_relaxed); }
+
+    private:
+        constexpr static uint8_t NO_BUFFER = 0xFF;
+        constexpr static uint8_t _MAX_WIDTH = 16;
+
+        Display &_display;
+        LCD_Region _regions[SLOTS];
+        char _buffers[BUFFERS][_MAX_WIDTH];
+        std::atomic<uint8_t> _latest[SLOTS];
+
+        // The free stack. The top is the index of the first free buffer in the low half and a count of every change to the stack
+        // in the high half. Without the count, a producer that read the top and its next, and was then interrupted while other
+        // threads took that buffer and gave it back, would put back a next that is no longer free
+        std::atomic<uint32_t> _free;
+        std::atomic<uint8_t> _next_free[BUFFERS];
+
+        std::atomic<uint32_t> _published{0}, _rendered{0}, _superseded{0}, _dropped{0};
+
+        uint8_t take_free(void) {
+            uint32_t top = _free.load(std::memory_order_acquire);
+            while (true) {
+                uint8_t buffer = top & 0xFFFF;
+                if (buffer == NO_BUFFER) return NO_BUFFER;
+
+                uint32_t next = _next_free[buffer].load(std::memory_order_relaxed);
+                if (_free.compare_exchange_weak(top, (top & 0xFFFF0000) + 0x10000 + next, std::memory_order_acquire)) {
+                    return buffer;
+                }
+            }
+        }
+
+        void give_free(uint8_t buffer) {
+            uint32_t top = _free.load(std::memory_order_relaxed);
+            do {
+                _next_free[buffer].store(top & 0xFFFF, std::memory_order_relaxed);
+            } while (!_free.compare_exchange_weak(top, (top & 0xFFFF0000) + 0x10000 + buffer, std::memory_order_release));
+        }
+};
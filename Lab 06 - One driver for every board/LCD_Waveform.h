@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdint.h>
+#include "LCD_Display.h"
+
+// Even with every delay trimmed to the datasheet, the CPU still has to be there for each byte: put it on the bus, raise E, drop E.
+// Here a whole frame of bus transactions is worked out in advance instead, as a list of steps. Each step holds one word per GPIO port
+// in the layout of the STM32 BSRR register: a 1 in the low half sets that pin, a 1 in the high half clears it, and a 0 leaves it alone.
+// Every write to the display takes three steps:
+//      step 0      RS and the byte onto the bus, E stays LOW
+//      step 1      E rises
+//      step 2      E falls and the display latches the byte
+// Steps are evenly spaced, STEP_NS apart, and three of them last as long as the display takes to write a character. Anything slower,
+// like a clear, is followed by idle steps where every word is 0. So the list can be handed to a timer and a DMA channel that write one
+// step to the port registers every tick, and the CPU never touches the bus while a frame goes out.
+//
+// Nothing in here knows which board it is running on. The pins come in as a description of which port and bit each one is on:
+//      constexpr static uint8_t PORT_COUNT                 how many ports the waveform has words for, numbered from 0
+//      constexpr static Port_Pin RS, E
+//      constexpr static Port_Pin DATA[8]                   DB0 first
+// RW isn't in the waveform at all. It has to be held LOW, with the bus pins set up as outputs, for as long as a frame is playing.
+struct Port_Pin {
+    uint8_t port;       // which GPIO port, counting from 0
+    uint8_t bit;        // which pin on that port, 0-15
+};
+
+template <typename Pins, uint16_t MAX_STEPS, typename Timing = HD44780_Timing>
+class LCD_Waveform {
+    public:
+        constexpr static uint8_t PORT_COUNT = Pins::PORT_COUNT;
+        constexpr static uint32_t STEPS_PER_WRITE = 3;
+        constexpr static uint32_t STEP_NS = (Timing::DATA_WRITE_US * 1000 + STEPS_PER_WRITE - 1) / STEPS_PER_WRITE;
+
+        // One step is plenty for every bus timing, and E rises three steps apart
+        static_assert(STEP_NS >= Timing::ADDRESS_SETUP_NS && STEP_NS >= Timing::ENABLE_PULSE_NS && STEP_NS >= Timing::DATA_HOLD_NS, "a step must cover tAS, PWEH and tH");
+        static_assert(STEPS_PER_WRITE * STEP_NS >= Timing::ENABLE_CYCLE_NS, "E must not rise again before tcycE is up");
+
+        constexpr LCD_Waveform(void) : _words{}, _length(0) {}
+
+        // Empties the waveform, ready for the next frame
+        constexpr void clear(void) {
+            for (uint8_t port = 0; port < PORT_COUNT; port++) {
+                for (uint16_t step = 0; step < _length; step++) {
+                    _words[port][step] = 0;
+                }
+            }
+            _length = 0;
+        }
+
+        // Each of these returns false, and adds nothing, if there isn't room for it
+        constexpr bool write_instruction(uint8_t instruction) {
+            return write(instruction, false, instruction <= _INSTR_RETURN_HOME ? Timing::CLEAR_US : Timing::INSTRUCTION_US);
+        }
+
+        constexpr bool write_data(uint8_t value) {
+            return write(value, true, Timing::DATA_WRITE_US);
+        }
+
+        constexpr bool set_cursor(uint8_t column, uint8_t row) {
+            return write_instruction(_INSTR_SET_DDRAM_ADDR | ((row & 1) * 0x40 + column));
+        }
+
+        // The whole screen, both lines from the first column. Short lines are padded with spaces so the frame covers everything left from the last one
+        constexpr bool write_frame(const char *top, const char *bottom, uint8_t columns = 16) {
+            const char *lines[2] = {top, bottom};
+            for (uint8_t row = 0; row < 2; row++) {
+                if (!set_cursor(0, row)) return false;
+                const char *text = lines[row];
+                for (uint8_t column = 0; column < columns; column++) {
+                    if (!write_data(*text ? *text++ : ' ')) return false;
+                }
+            }
+            return true;
+        }
+
+        constexpr uint16_t length(void) const { return _length; }                              // in steps
+        constexpr const uint32_t *words(uint8_t port) const { return _words[port]; }           // what goes to that port's set/reset register, one word per step
+        constexpr uint32_t duration_us(void) const { return (uint32_t(_length) * STEP_NS + 999) / 1000; }
+
+    private:
+        constexpr static uint8_t _INSTR_RETURN_HOME = 0b00000010;      // this and clear display are the slow ones
+        constexpr static uint8_t _INSTR_SET_DDRAM_ADDR = 0b10000000;
+
+        uint32_t _words[PORT_COUNT][MAX_STEPS];     // one array per port, so each can be given to its own DMA channel
+        uint16_t _length;
+
+        constexpr void drive(uint16_t step, Port_Pin pin, bool level) {
+            _words[pin.port][step] |= level ? 1UL << pin.bit : 1UL << (pin.bit + 16);
+        }
+
+        constexpr bool write(uint8_t value, bool register_select, uint32_t execution_us) {
+            // E falls again STEPS_PER_WRITE steps after this one does, so only something slower than a character needs idle steps after it
+            uint32_t steps_to_finish = (execution_us * 1000 + STEP_NS - 1) / STEP_NS;
+            uint32_t idle_steps = steps_to_finish > STEPS_PER_WRITE ? steps_to_finish - STEPS_PER_WRITE : 0;
+            if (_length + STEPS_PER_WRITE + idle_steps > MAX_STEPS) {
+                return false;
+            }
+
+            drive(_length, Pins::RS, register_select);
+            for (uint8_t i = 0; i < 8; i++) {
+                drive(_length, Pins::DATA[i], value & (1 << i));
+            }
+            drive(_length + 1, Pins::E, true);
+            drive(_length + 2, Pins::E, false);            // the falling edge is what latches the byte
+
+            _length += STEPS_PER_WRITE + idle_steps;        // idle steps are already 0
+            return true;
+        }
+};
@@ -0,0 +1,61 @@
+#include <Arduino.h>
+#include "LCD_Display.h"
+#include "Arduino_HAL.h"
+
+// RW is NOT_CONNECTED for timed mode. Use D11 to poll the busy flag instead, RW must be held LOW if it is wired up but not used
+typedef Uno_HAL<D12, NOT_CONNECTED, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_HAL;
+typedef LCD_Display<My_HAL> My_LCD_Display;
+
+// Time putting RS and every possible byte on the bus, and return how many CPU cycles each one took
+template <typename Bus_Writer>
+unsigned long cycles_per_byte(Bus_Writer write_bus) {
+    constexpr unsigned int BENCHMARK_BYTES = 256;
+
+    unsigned long started_us = micros();
+    for (unsigned int value = 0; value < BENCHMARK_BYTES; value++) {
+        write_bus(value);
+    }
+    unsigned long elapsed_us = micros() - started_us;
+    return elapsed_us * (F_CPU / 1000000UL) / BENCHMARK_BYTES;
+}
+
+void setup() {
+    Serial.begin(9600);
+
+    My_LCD_Display my_lcd_screen;
+
+    // The same thing written by hand for this one wiring, the way you would without a HAL. RS on D12 is PB4, DB0 and DB1 on D9 and D8
+    // are PB1 and PB0, and DB2-DB7 on D7-D2 are PD7 down to PD2. E is LOW, so the display ignores everything we put on the bus here
+    unsigned long hand_written = cycles_per_byte([](byte value) {
+        PORTB |= _BV(4);
+        byte port_b = (value & 0x01) << 1 | (value & 0x02) >> 1;
+        byte port_d = 0;
+        for (byte i = 2; i < 8; i++) {
+            if (value & (1 << i)) port_d |= 1 << (9 - i);
+        }
+        noInterrupts();
+        PORTB = (PORTB & (byte)~0x03) | port_b;
+        PORTD = (PORTD & 0x03) | port_d;
+        interrupts();
+    });
+    unsigned long through_the_hal = cycles_per_byte([](byte value) {
+        My_HAL::write_register_select(HIGH);
+        My_HAL::write_bus(value);
+    });
+
+    Serial.print("Hand written: ");
+    Serial.print(hand_written);
+    Serial.print(" cycles per byte, through the HAL: ");
+    Serial.print(through_the_hal);
+    Serial.print(" cycles per byte, ");
+    Serial.print((unsigned int)sizeof(my_lcd_screen));
+    Serial.println(" bytes of RAM per display");
+
+    my_lcd_screen.print_text("Hello World!!");
+    my_lcd_screen.set_cursor(0, 1);
+    my_lcd_screen.print_text("Arduino HAL");
+}
+
+void loop() {
+    // Do nothing for now
+}
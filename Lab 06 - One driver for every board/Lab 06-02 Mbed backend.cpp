@@ -0,0 +1,52 @@
+#include <mbed.h>
+#include "LCD_Display.h"
+#include "Mbed_HAL.h"
+
+typedef STM32_HAL<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_HAL;
+typedef LCD_Display<My_HAL> My_LCD_Display;
+
+// Time putting RS and a byte on the bus many times over, and return how many CPU cycles each one took
+template <typename Bus_Writer>
+unsigned int cycles_per_byte(Bus_Writer write_bus) {
+    constexpr unsigned int BENCHMARK_BYTES = 4096;
+
+    Timer timer;
+    timer.start();
+    for (unsigned int value = 0; value < BENCHMARK_BYTES; value++) {
+        write_bus(value & 0xFF);
+    }
+    timer.stop();
+    return (unsigned long long)timer.elapsed_time().count() * (SystemCoreClock / 1000000) / BENCHMARK_BYTES;
+}
+
+int main() {
+    My_LCD_Display my_lcd_screen;
+
+    // The same thing written by hand for this one wiring, the way you would without a HAL. On a NUCLEO-F401RE RS on D12 is PA_6,
+    // and the bus is spread over three ports: DB0 on PC_7, DB1, DB2 and DB7 on PA_9, PA_8 and PA_10, DB3-DB6 on PB_10, PB_4, PB_5 and PB_3.
+    // E is LOW, so the display ignores everything we put on the bus here
+    unsigned int hand_written = cycles_per_byte([](uint8_t value) {
+        GPIOA->BSRR = 1UL << 6;
+        uint32_t port_a = (value & 0x02 ? 1UL << 9 : 0) | (value & 0x04 ? 1UL << 8 : 0) | (value & 0x80 ? 1UL << 10 : 0);
+        uint32_t port_b = (value & 0x08 ? 1UL << 10 : 0) | (value & 0x10 ? 1UL << 4 : 0) | (value & 0x20 ? 1UL << 5 : 0) | (value & 0x40 ? 1UL << 3 : 0);
+        uint32_t port_c = value & 0x01 ? 1UL << 7 : 0;
+        GPIOA->BSRR = port_a | ((0x0700 & ~port_a) << 16);
+        GPIOB->BSRR = port_b | ((0x0438 & ~port_b) << 16);
+        GPIOC->BSRR = port_c | ((0x0080 & ~port_c) << 16);
+    });
+    unsigned int through_the_hal = cycles_per_byte([](uint8_t value) {
+        My_HAL::write_register_select(1);
+        My_HAL::write_bus(value);
+    });
+
+    printf("Hand written: %u cycles per byte, through the HAL: %u cycles per byte, %u bytes of RAM per display\n",
+        hand_written, through_the_hal, (unsigned int)sizeof(my_lcd_screen));
+
+    my_lcd_screen.print_text("Hello World!!");
+    my_lcd_screen.set_cursor(0, 1);
+    my_lcd_screen.print_text("Mbed HAL");
+
+	while(true) {
+		// put your main code here, to run repeatedly:
+	}
+}
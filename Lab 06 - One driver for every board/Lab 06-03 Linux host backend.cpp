@@ -0,0 +1,51 @@
+#include <cstdio>
+#include "LCD_Display.h"
+#include "Host_HAL.h"
+
+// No Arduino.h or mbed.h here, this is a plain Linux program. The driver runs against the simulated board, so changes to it can be
+// tried out and checked for timing problems on a PC. HD44780_SIM_STRICT=1 makes any violation fail the run
+typedef Host_HAL<0> My_HAL;
+typedef LCD_Display<My_HAL> My_LCD_Display;
+
+// Time putting RS and every possible byte on the bus, and return how many CPU cycles each one took
+template <typename Bus_Writer>
+unsigned long cycles_per_byte(Bus_Writer write_bus) {
+    constexpr unsigned int BENCHMARK_BYTES = 256;
+
+    uint64_t started = simulated_board.cycles();
+    for (unsigned int value = 0; value < BENCHMARK_BYTES; value++) {
+        write_bus(value);
+    }
+    return (simulated_board.cycles() - started) / BENCHMARK_BYTES;
+}
+
+int main(void) {
+    My_LCD_Display my_lcd_screen;
+
+    // The same thing written by hand, straight to the simulated board
+    unsigned long hand_written = cycles_per_byte([](uint8_t value) {
+        simulated_board.advance_cycles(host_costs::GPIO_ACCESS);
+        simulated_board.write_pin(Simulated_Board::REGISTER_SELECT_PIN, true);
+        uint32_t bus_mask = 0, levels = 0;
+        for (uint8_t i = 0; i < 8; i++) {
+            bus_mask |= 1UL << Simulated_Board::DATA_BUS_PINS[i];
+            if (value & (1 << i)) levels |= 1UL << Simulated_Board::DATA_BUS_PINS[i];
+        }
+        simulated_board.advance_cycles(host_costs::GPIO_ACCESS);
+        simulated_board.write_pins(bus_mask, levels);
+    });
+    unsigned long through_the_hal = cycles_per_byte([](uint8_t value) {
+        My_HAL::write_register_select(true);
+        My_HAL::write_bus(value);
+    });
+
+    std::printf("Hand written: %lu cycles per byte, through the HAL: %lu cycles per byte, %u bytes of RAM per display\n",
+        hand_written, through_the_hal, (unsigned int)sizeof(my_lcd_screen));
+
+    my_lcd_screen.print_text("Hello World!!");
+    my_lcd_screen.set_cursor(0, 1);
+    my_lcd_screen.print_text("Linux host HAL");
+
+    simulated_board.print_report();
+    return simulated_board.exit_code();
+}
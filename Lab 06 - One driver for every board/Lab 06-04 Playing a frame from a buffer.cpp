@@ -0,0 +1,75 @@
+#include <cstdio>
+#include <cstring>
+#include "LCD_Display.h"
+#include "LCD_Waveform.h"
+#include "Host_HAL.h"
+#include "Host_Waveform_Player.h"
+
+// The driver still sets the display up, then whole frames are sent by playing a waveform out of a buffer. On an STM32 that is
+// STM32_Waveform_Player.h, a timer and three DMA streams. Here the same waveform goes into the simulated board, which checks every
+// edge against the datasheet, and afterwards we read back what the display shows to make sure it is what we asked for
+typedef Host_HAL<0> My_HAL;
+typedef LCD_Display<My_HAL> My_LCD_Display;
+typedef LCD_Waveform<Host_Waveform_Pins<0>, 2 * (16 + 1) * 3> My_Waveform;     // two lines, each a set cursor and 16 characters
+
+// Worked out entirely by the compiler, so on a board the whole waveform would sit in flash
+constexpr My_Waveform SPLASH_SCREEN = [] {
+    My_Waveform waveform;
+    waveform.write_frame("Hello World!!", "Played by DMA");
+    return waveform;
+}();
+
+// Compares what the display is showing with what the frame was meant to show, and prints both if they differ
+bool screen_matches(const char *top, const char *bottom) {
+    const char *lines[2] = {top, bottom};
+    bool matches = true;
+    for (uint8_t row = 0; row < 2; row++) {
+        std::string expected(lines[row]);
+        expected.resize(16, ' ');
+        std::string shown = simulated_board.display(0).visible_line(row);
+        if (shown != expected) {
+            std::printf("Line %u shows \"%s\", expected \"%s\"\n", row, shown.c_str(), expected.c_str());
+            matches = false;
+        }
+    }
+    return matches;
+}
+
+int main(void) {
+    My_LCD_Display my_lcd_screen;
+    bool all_matched = true;
+
+    // The constructor's clear is still running, and the waveform starts writing straight away
+    simulated_board.advance_ns(HD44780_Timing::CLEAR_US * 1000);
+
+    Host_Waveform_Player::play(SPLASH_SCREEN);
+    all_matched &= screen_matches("Hello World!!", "Played by DMA");
+
+    // Frames that change are built at run time, into RAM
+    static My_Waveform frame;
+    char count[17];
+    for (int i = 1; i <= 3; i++) {
+        std::snprintf(count, sizeof(count), "Frame %d of 3", i);
+        frame.clear();
+        frame.write_frame(count, "Built at runtime");
+        Host_Waveform_Player::play(frame);
+        all_matched &= screen_matches(count, "Built at runtime");
+    }
+
+    // The same frame sent by the CPU, which has to stay with it until the last byte has gone
+    simulated_board.advance_ns(My_Waveform::STEP_NS * My_Waveform::STEPS_PER_WRITE);
+    uint64_t started_ns = simulated_board.now_ns();
+    my_lcd_screen.set_cursor(0, 0);
+    my_lcd_screen.print_text("Frame 3 of 3    ", 16);
+    my_lcd_screen.set_cursor(0, 1);
+    my_lcd_screen.print_text("Built at runtime", 16);
+    uint64_t cpu_ns = simulated_board.now_ns() - started_ns;
+
+    std::printf("Waveform: %u steps of %lu ns, %u bytes, %lu us per frame with the CPU free the whole time\n",
+        frame.length(), (unsigned long)My_Waveform::STEP_NS, (unsigned int)sizeof(frame), (unsigned long)frame.duration_us());
+    std::printf("CPU driven: %lu us per frame with the CPU busy the whole time\n", (unsigned long)(cpu_ns / 1000));
+    std::printf("Display contents %s\n", all_matched ? "matched every frame" : "did NOT match");
+
+    simulated_board.print_report();
+    return all_matched ? simulated_board.exit_code() : 1;
+}
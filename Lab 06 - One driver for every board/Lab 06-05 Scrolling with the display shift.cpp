@@ -0,0 +1,51 @@
+#include <Arduino.h>
+#include "LCD_Display.h"
+#include "Arduino_HAL.h"
+
+typedef Uno_HAL<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_HAL;
+typedef LCD_Display<My_HAL> My_LCD_Display;
+
+constexpr unsigned long MARQUEE_STEP_MS = 250;
+constexpr byte BENCHMARK_STEPS = 40;        // once all the way round the display's memory
+
+const char MESSAGE[] = "Scrolling with the display shift, one column at a time    ";
+
+My_LCD_Display *my_lcd_screen;
+
+void setup() {
+    Serial.begin(9600);
+
+    static My_LCD_Display lcd_screen;
+    my_lcd_screen = &lcd_screen;
+
+    // The old way, sending the whole visible part of the line again for every step
+    unsigned long started_us = micros();
+    for (byte step = 0; step < BENCHMARK_STEPS; step++) {
+        char window[16];
+        for (byte column = 0; column < 16; column++) {
+            window[column] = MESSAGE[(step + column) % (sizeof(MESSAGE) - 1)];
+        }
+        my_lcd_screen->set_cursor(0, 0);
+        my_lcd_screen->print_text(window, 16);
+    }
+    unsigned long rewriting_us = (micros() - started_us) / BENCHMARK_STEPS;
+
+    // Shifting the display, and only filling in the column that has just gone out of sight
+    my_lcd_screen->start_marquee(MESSAGE);
+    started_us = micros();
+    for (byte step = 0; step < BENCHMARK_STEPS; step++) {
+        my_lcd_screen->marquee_step();
+    }
+    unsigned long shifting_us = (micros() - started_us) / BENCHMARK_STEPS;
+
+    Serial.print("Rewriting the line: ");
+    Serial.print(rewriting_us);
+    Serial.print(" us per step, shifting the display: ");
+    Serial.print(shifting_us);
+    Serial.println(" us per step");
+}
+
+void loop() {
+    delay(MARQUEE_STEP_MS);
+    my_lcd_screen->marquee_step();
+}
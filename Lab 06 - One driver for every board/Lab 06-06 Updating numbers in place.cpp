@@ -0,0 +1,90 @@
+#include <Arduino.h>
+#include "LCD_Display.h"
+#include "LCD_Field.h"
+#include "Arduino_HAL.h"
+
+typedef Uno_HAL<D12, NOT_CONNECTED, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_HAL;
+typedef LCD_Display<My_HAL> My_LCD_Display;
+
+constexpr unsigned int SENSOR_READINGS = 1000;      // one a millisecond, for a second
+constexpr unsigned long RPM_INTERVAL_US = 100000;   // ten updates a second is as fast as anyone can read a number
+constexpr unsigned long TEMPERATURE_INTERVAL_US = 250000;
+
+// A pretend engine. The RPM wobbles around 3000 on every reading, the temperature creeps up a tenth of a degree at a time
+long read_rpm(unsigned int reading) { return 3000 + (long)(reading * 7 % 23) - 11; }
+long read_temperature(unsigned int reading) { return -50 + (long)reading / 8; }    // tenths of a degree
+
+My_LCD_Display *my_lcd_screen;
+LCD_Field<My_LCD_Display, 5> *rpm_field;
+LCD_Field<My_LCD_Display, 5> *temperature_field;
+unsigned int reading = 0;
+
+void setup() {
+    Serial.begin(9600);
+
+    static My_LCD_Display lcd_screen;
+    my_lcd_screen = &lcd_screen;
+
+    // The old way, a String for every reading and the whole number sent again. Only the simulator can count heap allocations, see
+    // simulated_heap_allocations
+#ifdef HOST_SIMULATOR
+    unsigned long allocations = simulated_heap_allocations;
+#endif
+    unsigned long rewriting_us = 0;
+    for (unsigned int i = 0; i < SENSOR_READINGS; i++) {
+        unsigned long started_us = micros();
+        String rpm(read_rpm(i));
+        my_lcd_screen->set_cursor(0, 0);
+        my_lcd_screen->print_text("RPM");
+        my_lcd_screen->set_cursor(16 - rpm.length(), 0);
+        my_lcd_screen->print_text(rpm.c_str());
+        rewriting_us += micros() - started_us;
+        delay(1);
+    }
+
+    // Fields, only sending digits that changed, and no more than ten times a second
+    my_lcd_screen->set_cursor(0, 0);
+    my_lcd_screen->print_text("RPM             ", 16);
+    my_lcd_screen->set_cursor(0, 1);
+    my_lcd_screen->print_text("Temp", 4);
+    static LCD_Field<My_LCD_Display, 5> rpm(lcd_screen, 11, 0, 0, RPM_INTERVAL_US);
+    static LCD_Field<My_LCD_Display, 5> temperature(lcd_screen, 11, 1, 1, TEMPERATURE_INTERVAL_US);
+    rpm_field = &rpm;
+    temperature_field = &temperature;
+
+#ifdef HOST_SIMULATOR
+    unsigned long rewriting_allocations = simulated_heap_allocations - allocations;
+    allocations = simulated_heap_allocations;
+#endif
+    unsigned long field_us = 0;
+    for (unsigned int i = 0; i < SENSOR_READINGS; i++) {
+        unsigned long started_us = micros();
+        rpm.set(read_rpm(i));
+        field_us += micros() - started_us;
+        delay(1);
+    }
+
+    Serial.print("A second of RPM readings, rewriting the number: ");
+    Serial.print(rewriting_us);
+    Serial.print(" us on the display, fields: ");
+    Serial.print(field_us);
+    Serial.println(" us");
+#ifdef HOST_SIMULATOR
+    unsigned long field_allocations = simulated_heap_allocations - allocations;
+    Serial.print("Heap allocations, rewriting the number: ");
+    Serial.print(rewriting_allocations);
+    Serial.print(", fields: ");
+    Serial.println(field_allocations);
+    if (field_allocations != 0) {
+        simulated_board.fail("LCD_Field::set() used the heap");
+    }
+#endif
+}
+
+void loop() {
+    // The sensors are read every millisecond, the fields decide when the display hears about it
+    rpm_field->set(read_rpm(reading));
+    temperature_field->set(read_temperature(reading));
+    reading++;
+    delay(1);
+}
@@ -0,0 +1,154 @@
+#include <mbed.h>
+#include <atomic>
+#include <cstring>
+#include "LCD_Display.h"
+#include "LCD_Slots.h"
+#include "Mbed_HAL.h"
+
+typedef STM32_HAL<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_HAL;
+typedef LCD_Display<My_HAL> My_LCD_Display;
+
+constexpr uint8_t PRODUCERS = 8;
+constexpr unsigned int UPDATES_PER_PRODUCER = 100000;
+
+// Four quarters of the screen, every producer writes to all of them
+constexpr uint8_t SLOT_COUNT = 4;
+constexpr uint8_t SLOT_WIDTH = 8;
+const LCD_Region REGIONS[SLOT_COUNT] = {{0, 0, SLOT_WIDTH}, {8, 0, SLOT_WIDTH}, {0, 1, SLOT_WIDTH}, {8, 1, SLOT_WIDTH}};
+
+// What a producer puts in a slot: its number, a count that only goes up, and a check letter worked out from both, eg "3:01234q".
+// Text that was torn, half from one update and half from another, almost never has the right check letter. Each producer's last
+// update to every slot is "3:done"
+char check_letter(unsigned int producer, unsigned int count) { return 'a' + (producer * 7 + count) % 26; }
+
+void format_update(char text[SLOT_WIDTH + 1], unsigned int producer, unsigned int count) {
+    snprintf(text, SLOT_WIDTH + 1, "%u:%05u%c", producer, count, check_letter(producer, count));
+}
+
+// Stands between the slots and the driver, and checks everything the renderer sends: that it is whole, and that no slot ever goes
+// back to an older update from the same producer. On a board it works just as well, it only costs the renderer a little time
+class Checked_Display {
+    public:
+        Checked_Display(My_LCD_Display &display) : _display(display) {
+            for (auto &slot : _last_count) {
+                for (int &count : slot) count = -1;
+            }
+        }
+
+        void set_cursor(uint8_t column, uint8_t row) {
+            _slot = row * 2 + column / SLOT_WIDTH;
+            _display.set_cursor(column, row);
+        }
+
+        void print_text(const char *text, uint8_t length) {
+            check(text, length);
+            memcpy(_shown[_slot], text, length);
+            _display.print_text(text, length);
+        }
+
+        bool is_done(uint8_t slot) const { return memcmp(_shown[slot] + 1, ":done", 5) == 0; }
+
+        unsigned int torn = 0, out_of_order = 0;
+
+    private:
+        My_LCD_Display &_display;
+        uint8_t _slot = 0;
+        char _shown[SLOT_COUNT][SLOT_WIDTH] = {};
+        int _last_count[SLOT_COUNT][PRODUCERS];
+
+        void check(const char *text, uint8_t length) {
+            unsigned int producer = text[0] - '0';
+            if (length != SLOT_WIDTH || producer >= PRODUCERS || text[1] != ':') {
+                torn++;
+                return;
+            }
+            if (memcmp(text + 2, "done  ", 6) == 0) return;
+
+            unsigned int count = 0;
+            for (uint8_t i = 2; i < 7; i++) {
+                if (text[i] < '0' || text[i] > '9') {
+                    torn++;
+                    return;
+                }
+                count = count * 10 + (text[i] - '0');
+            }
+            if (text[7] != check_letter(producer, count)) {
+                torn++;
+                return;
+            }
+            if ((int)count <= _last_count[_slot][producer]) out_of_order++;
+            _last_count[_slot][producer] = count;
+        }
+};
+
+// A buffer for each slot, one for the renderer and one for each producer that might be halfway through publishing
+typedef LCD_Slots<Checked_Display, SLOT_COUNT, SLOT_COUNT + 1 + PRODUCERS> My_Slots;
+
+int main() {
+    My_LCD_Display my_lcd_screen;
+    Checked_Display checked_screen(my_lcd_screen);
+    My_Slots slots(checked_screen, REGIONS);
+
+    // The renderer is the only thread that ever touches the display. In an application it would render once a frame and sleep in
+    // between, leaving the display alone however much is published meanwhile. Here it goes flat out, so that it is forever taking
+    // content out of the slots at the same moment the producers are swapping new content in, which is the case that has to hold up.
+    // It runs at the producers' priority. ThisThread::yield() only hands the CPU to threads of the same priority, so any lower and
+    // on a board it wouldn't get a turn until every producer had finished
+    std::atomic<bool> stopping{false};
+    unsigned int frames = 0;
+    Thread renderer(osPriorityNormal);
+    renderer.start([&] {
+        while (!stopping) {
+            if (slots.render() > 0) {
+                frames++;
+            }
+            else {
+                ThisThread::yield();
+            }
+        }
+        frames += slots.render() > 0;       // whatever came in after the last frame
+    });
+
+    // The producers go as fast as they can, far faster than the display could ever keep up with, and never wait for it.
+    // On the host these are real threads running in parallel, which is a much harder test than one core taking turns
+    Thread producers[PRODUCERS];
+    for (unsigned int producer = 0; producer < PRODUCERS; producer++) {
+        producers[producer].start([&slots, producer] {
+            char text[SLOT_WIDTH + 1];
+            for (unsigned int count = 0; count < UPDATES_PER_PRODUCER; count++) {
+                format_update(text, producer, count);
+                slots.publish((producer + count) % SLOT_COUNT, text);
+                if (count % 256 == 0) ThisThread::yield();      // so the renderer gets turns on a single core, between time slices too
+            }
+            snprintf(text, sizeof(text), "%u:done", producer);
+            for (uint8_t slot = 0; slot < SLOT_COUNT; slot++) {
+                slots.publish(slot, text);
+            }
+        });
+    }
+    for (Thread &producer : producers) {
+        producer.join();
+    }
+    stopping = true;
+    renderer.join();
+
+    // Whichever producer published to a slot last, its last update there was "done", so that is what every slot must show
+    bool all_done = true;
+    for (uint8_t slot = 0; slot < SLOT_COUNT; slot++) {
+        all_done &= checked_screen.is_done(slot);
+    }
+    bool accounted = slots.published() == slots.rendered() + slots.superseded();
+
+    printf("%u producers published %lu updates, %lu were rendered in %u frames and %lu superseded before they got there, %lu dropped\n",
+        (unsigned int)PRODUCERS, (unsigned long)slots.published(), (unsigned long)slots.rendered(), frames,
+        (unsigned long)slots.superseded(), (unsigned long)slots.dropped());
+    printf("Torn updates: %u, out of order: %u, every update accounted for: %s, final screen %s\n",
+        checked_screen.torn, checked_screen.out_of_order, accounted ? "yes" : "NO", all_done ? "shows the last updates" : "is NOT the last updates");
+
+    // Any of these failing is a bug in the slots, so the run has to fail with it. Mbed ignores what main() returns, so exit instead
+    if (checked_screen.torn || checked_screen.out_of_order || !accounted || !all_done) {
+        fflush(stdout);
+        exit(1);
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <Arduino.h>
+#include "LCD_Display.h"
+#include "LCD_Asset.h"
+#include "Arduino_HAL.h"
+
+typedef Uno_HAL<D12, D11, D10, D9, D8, D7, D6, D5, D4, D3, D2> My_HAL;
+typedef LCD_Display<My_HAL> My_LCD_Display;
+
+constexpr unsigned long ALARM_FLASH_MS = 500;
+const char FIRMWARE_VERSION[] = "1.2.0";
+
+constexpr uint8_t ARROW[8] = {0b00000, 0b01000, 0b01100, 0b01110, 0b01100, 0b01000, 0b00000, 0b00000};
+constexpr uint8_t BELL[8] = {0b00100, 0b01110, 0b01110, 0b01110, 0b11111, 0b00000, 0b00100, 0b00000};
+
+// Every one of these is worked out by the compiler and stays in flash. None of them costs any RAM, or any time before it is drawn
+constexpr auto BOOT_SCREEN PROGMEM = lcd_asset([] {
+    LCD_Screen screen;
+    screen.text(2, 0, "HAL dev kit").text(0, 1, "Firmware v1.2.0");
+    return screen;
+});
+
+constexpr auto MENU_SCREEN PROGMEM = lcd_asset([] {
+    LCD_Screen screen;
+    screen.glyph(0, ARROW).character(0, 0, 0).text(1, 0, "Set alarm").text(1, 1, "Settings");
+    screen.cursor(0, 0, LCD_Screen::cursor_blink);
+    return screen;
+});
+
+constexpr auto ALARM_SCREEN PROGMEM = lcd_asset([] {
+    LCD_Screen screen;
+    screen.glyph(1, BELL).character(0, 0, 1).text(2, 0, "Alarm 07:30").character(15, 0, 1).text(0, 1, "****************");
+    return screen;
+});
+
+// Checked before the program is ever run
+static_assert(ALARM_SCREEN.draw_time_us() < 2000, "the alarm has to be on screen within 2ms of going off");
+
+My_LCD_Display *my_lcd_screen;
+bool alarm_showing = false;
+
+// Draws an asset and prints what it cost. The asset's numbers are read by the compiler, not out of flash, so they are right on an AVR too
+template <const auto &ASSET>
+void draw_and_report(const char *name) {
+    constexpr uint16_t BYTES = ASSET.size();
+    constexpr uint16_t TRANSACTIONS = ASSET.transactions();
+    constexpr uint32_t DRAW_TIME_US = ASSET.draw_time_us();
+
+    unsigned long started_us = micros();
+    my_lcd_screen->play(ASSET);
+    unsigned long drawn_us = micros() - started_us;
+
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print(BYTES);
+    Serial.print(" bytes of flash for ");
+    Serial.print(TRANSACTIONS);
+    Serial.print(" writes, ");
+    Serial.print(DRAW_TIME_US);
+    Serial.print(" us estimated, ");
+    Serial.print(drawn_us);
+    Serial.println(" us drawing it");
+}
+
+void setup() {
+    Serial.begin(9600);
+
+    static My_LCD_Display lcd_screen;
+    my_lcd_screen = &lcd_screen;
+
+    // The old way, the boot screen put together out of Strings and padded out to cover whatever was there before. Only the simulator
+    // can count heap allocations, see simulated_heap_allocations
+#ifdef HOST_SIMULATOR
+    unsigned long allocations = simulated_heap_allocations;
+#endif
+    unsigned long started_us = micros();
+    String top = "  HAL dev kit";
+    String bottom = String("Firmware v") + FIRMWARE_VERSION;
+    while (top.length() < 16) top += ' ';
+    while (bottom.length() < 16) bottom += ' ';
+    my_lcd_screen->set_cursor(0, 0);
+    my_lcd_screen->print_text(top.c_str());
+    my_lcd_screen->set_cursor(0, 1);
+    my_lcd_screen->print_text(bottom.c_str());
+    unsigned long string_us = micros() - started_us;
+
+    Serial.print("Boot screen from Strings: ");
+    Serial.print(string_us);
+#ifdef HOST_SIMULATOR
+    Serial.print(" us, ");
+    Serial.print(simulated_heap_allocations - allocations);
+    Serial.println(" heap allocations");
+#else
+    Serial.println(" us");
+#endif
+
+    draw_and_report<BOOT_SCREEN>("Boot screen");
+    draw_and_report<MENU_SCREEN>("Menu screen");
+    draw_and_report<ALARM_SCREEN>("Alarm screen");
+    alarm_showing = true;
+}
+
+void loop() {
+    // The alarm flashes by switching between two whole screens, each one a single play() straight out of flash
+    delay(ALARM_FLASH_MS);
+    if (alarm_showing) {
+        my_lcd_screen->play(MENU_SCREEN);
+    }
+    else {
+        my_lcd_screen->play(ALARM_SCREEN);
+    }
+    alarm_showing = !alarm_showing;
+}
@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <cstring>
+#include "LCD_Display.h"
+#include "LCD_Charset.h"
+#include "Host_HAL.h"
+
+// A display with the Japanese A00 ROM, the one most modules come with. The simulated display only knows ASCII, so to check the
+// result we read back the character codes it was sent, rather than what its screen would look like
+typedef Host_HAL<0> My_HAL;
+typedef LCD_Display<My_HAL> My_LCD_Display;
+
+// Neither ROM has a euro sign, so it gets a custom character. PROGMEM, because transcode() reads the tables out of flash on an AVR
+constexpr LCD_Glyph EURO = {0x20AC, {0b00110, 0b01001, 0b11100, 0b01000, 0b11100, 0b01001, 0b00110, 0b00000}};
+constexpr LCD_Charset<rom_a00, 1> MY_CHARSET PROGMEM = LCD_Charset<rom_a00, 1>({EURO});
+
+// Transcoded by the compiler. The program only holds the character codes
+constexpr auto ALARM = "アラーム 07:30"_a00;
+constexpr auto PRICE = MY_CHARSET.literal("Price 5€ →");
+constexpr auto READING = "21.5°C 120µs"_a00;
+constexpr auto TEMPERATURE = "21.5°C"_a00;
+
+static_assert(ALARM.length() == 10, "four katakana, a space and the time, one cell each");
+static_assert(PRICE[7] == 0, "the euro sign is custom character 0");
+
+void print_codes(const char *name, const char *codes, uint8_t length) {
+    std::printf("%-28s", name);
+    for (uint8_t i = 0; i < length; i++) {
+        std::printf(" %02X", (uint8_t)codes[i]);
+    }
+    std::printf("\n");
+}
+
+// Compares the character codes on a row of the display with what we meant to send
+bool row_shows(uint8_t row, const LCD_Text<> &text) {
+    bool matches = true;
+    for (uint8_t column = 0; column < text.length(); column++) {
+        matches &= simulated_board.display(0).visible_character(row, column) == text[column];
+    }
+    return matches;
+}
+
+int main(void) {
+    My_LCD_Display my_lcd_screen;
+    bool all_matched = true;
+
+    // Sent as they are, the bytes of UTF-8 are just more characters to the display. The degree sign alone is two of them
+    const char *raw = "21.5°C";
+    print_codes("UTF-8 sent as it is:", raw, std::strlen(raw));
+    print_codes("Transcoded for the A00 ROM:", TEMPERATURE.data(), TEMPERATURE.length());
+
+    my_lcd_screen.print_text(ALARM.data(), ALARM.length());
+    all_matched &= row_shows(0, ALARM);
+
+    MY_CHARSET.load_glyphs(my_lcd_screen);
+    my_lcd_screen.set_cursor(0, 1);
+    my_lcd_screen.print_text(PRICE.data(), PRICE.length());
+    all_matched &= row_shows(1, PRICE);
+    all_matched &= simulated_board.display(0).cgram(1) == EURO.rows[1];
+
+    // A reading formatted at run time goes through the tables, and has to come out the same as the literal did
+    char buffer[32];
+    int tenths = 215, microseconds = 120;
+    std::snprintf(buffer, sizeof(buffer), "%d.%d°C %dµs", tenths / 10, tenths % 10, microseconds);
+    LCD_Text<> reading = MY_CHARSET.transcode(buffer);
+    all_matched &= reading.length() == READING.length() && std::memcmp(reading.data(), READING.data(), READING.length()) == 0;
+
+    my_lcd_screen.set_cursor(0, 0);
+    my_lcd_screen.print_text(reading.data(), reading.length());
+    all_matched &= row_shows(0, READING);
+
+    print_codes("Transcoded at run time:", reading.data(), reading.length());
+    std::printf("Tables for run time transcoding: %u bytes of flash, literals: none\n", (unsigned int)sizeof(MY_CHARSET));
+    std::printf("Display contents %s\n", all_matched ? "matched" : "did NOT match");
+
+    simulated_board.print_report();
+    return all_matched ? simulated_board.exit_code() : 1;
+}
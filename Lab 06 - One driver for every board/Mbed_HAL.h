@@ -0,0 +1,133 @@
+#pragma once
+
+#include <mbed.h>
+
+// The HAL for Mbed on an STM32 board, with the pins fixed at compile time the same way as Lab 03-02.
+// Use NC as the read/write pin on boards where RW is tied to ground
+
+template <PinName PIN>
+inline GPIO_TypeDef *gpio_port(void) {
+    static_assert(STM_PORT(PIN) <= 2, "only GPIO ports A to C are on the Arduino header");
+    if constexpr (STM_PORT(PIN) == 0) return GPIOA;
+    else if constexpr (STM_PORT(PIN) == 1) return GPIOB;
+    else return GPIOC;
+}
+
+// BSRR sets the pins in its low half and clears the ones in its high half, in a single store. No read-modify-write, so nothing to lock
+template <PinName PIN>
+inline void write_pin(bool level) {
+    gpio_port<PIN>()->BSRR = level ? 1UL << STM_PIN(PIN) : 1UL << (STM_PIN(PIN) + 16);
+}
+
+template <PinName RS, PinName RW, PinName E, PinName DB0, PinName DB1, PinName DB2, PinName DB3, PinName DB4, PinName DB5, PinName DB6, PinName DB7>
+class STM32_HAL {
+    public:
+        constexpr static bool HAS_READ_WRITE = RW != NC;
+        constexpr static uint32_t NOW_RESOLUTION_US = 1;
+
+        static void begin(void) {
+            // Let the HAL turn the port clocks on and set the pins up as outputs, once. After that we go straight to the registers
+            DigitalOut(RS, 0);
+            DigitalOut(E, 0);                       // E idles LOW, the display latches whatever is on the bus when it falls
+            if constexpr (HAS_READ_WRITE) {
+                DigitalOut(RW, 0);                  // LOW = Write mode, HIGH = Read Mode
+            }
+            BusOut(DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7).write(0);
+        }
+
+        static void write_register_select(bool level) { write_pin<RS>(level); }
+        static void write_read_write(bool level) { write_pin<RW>(level); }
+        static void write_enable(bool level) { write_pin<E>(level); }
+
+        static void write_bus(uint8_t value) {
+            write_port<0>(value);
+            write_port<1>(value);
+            write_port<2>(value);
+        }
+
+        static uint8_t read_bus(void) {
+            return read_port<0>() | read_port<1>() | read_port<2>();
+        }
+
+        static void release_bus(void) {
+            set_direction<0>(false);
+            set_direction<1>(false);
+            set_direction<2>(false);
+            GPIO_TypeDef *port = gpio_port<DB7>();
+            port->PUPDR = (port->PUPDR & ~(3UL << (STM_PIN(DB7) * 2))) | (1UL << (STM_PIN(DB7) * 2));
+        }
+
+        static void take_bus(void) {
+            GPIO_TypeDef *port = gpio_port<DB7>();
+            port->PUPDR = port->PUPDR & ~(3UL << (STM_PIN(DB7) * 2));
+            set_direction<0>(true);
+            set_direction<1>(true);
+            set_direction<2>(true);
+        }
+
+        static void delay_ns(uint32_t ns) { wait_ns(ns); }
+        static uint32_t now_us(void) { return us_ticker_read(); }
+
+    private:
+        constexpr static PinName _PINS[8] = {DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7};
+
+        // Which pins of a port belong to the bus, worked out by the compiler
+        constexpr static uint32_t port_mask(uint32_t port) {
+            uint32_t mask = 0;
+            for (uint8_t i = 0; i < 8; i++) {
+                if (STM_PORT(_PINS[i]) == port) mask |= 1UL << STM_PIN(_PINS[i]);
+            }
+            return mask;
+        }
+
+        // Two bits per pin in MODER and PUPDR
+        constexpr static uint32_t port_mode_mask(uint32_t port) {
+            uint32_t mask = 0;
+            for (uint8_t i = 0; i < 8; i++) {
+                if (STM_PORT(_PINS[i]) == port) mask |= 3UL << (STM_PIN(_PINS[i]) * 2);
+            }
+            return mask;
+        }
+
+        template <uint32_t PORT>
+        static GPIO_TypeDef *port_registers(void) {
+            if constexpr (PORT == 0) return GPIOA;
+            else if constexpr (PORT == 1) return GPIOB;
+            else return GPIOC;
+        }
+
+        template <uint32_t PORT>
+        static void write_port(uint8_t value) {
+            constexpr uint32_t MASK = port_mask(PORT);
+            if constexpr (MASK != 0) {              // ports the bus isn't on don't generate any code at all
+                uint32_t set = 0;
+                for (uint8_t i = 0; i < 8; i++) {   // every test and shift here is a constant, so this unrolls into a handful of bit moves
+                    if (STM_PORT(_PINS[i]) == PORT && (value & (1 << i))) set |= 1UL << STM_PIN(_PINS[i]);
+                }
+                port_registers<PORT>()->BSRR = set | ((MASK & ~set) << 16);    // every bus pin on this port changes in the same store
+            }
+        }
+
+        template <uint32_t PORT>
+        static uint8_t read_port(void) {
+            constexpr uint32_t MASK = port_mask(PORT);
+            uint8_t value = 0;
+            if constexpr (MASK != 0) {
+                uint32_t levels = port_registers<PORT>()->IDR;
+                for (uint8_t i = 0; i < 8; i++) {
+                    if (STM_PORT(_PINS[i]) == PORT && (levels & (1UL << STM_PIN(_PINS[i])))) value |= 1 << i;
+                }
+            }
+            return value;
+        }
+
+        template <uint32_t PORT>
+        static void set_direction(bool output) {
+            constexpr uint32_t MODE_MASK = port_mode_mask(PORT);
+            if constexpr (MODE_MASK != 0) {
+                constexpr uint32_t OUTPUT_MODE = MODE_MASK & 0x55555555;    // 01 in each pin's two bits is general purpose output, 00 is input
+                GPIO_TypeDef *port = port_registers<PORT>();
+                port->MODER = (port->MODER & ~MODE_MASK) | (output ? OUTPUT_MODE : 0);
+            }
+        }
+};
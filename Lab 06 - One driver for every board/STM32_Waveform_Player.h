@@ -0,0 +1,93 @@
+#pragma once
+
+#include <mbed.h>
+#include "LCD_Waveform.h"
+
+// Plays a waveform out of the GPIO ports with a timer and DMA, on an STM32F401 like the NUCLEO-F401RE. TIM1 asks DMA2 for a transfer
+// on each of its first three compare channels, and each of those DMA streams copies the next word for one port into its BSRR.
+// DMA2 is the one that can reach the GPIO ports on AHB1, DMA1 can't. From RM0368 table 28, all on DMA channel 6:
+//      TIM1_CH1 -> DMA2 stream 1 -> GPIOA
+//      TIM1_CH2 -> DMA2 stream 2 -> GPIOB
+//      TIM1_CH3 -> DMA2 stream 6 -> GPIOC
+// All three channels compare at the same count, so every port moves on to the next step on the same tick.
+// BSRR only changes the pins with a 1 written to them, so the CPU can go on using the other pins on these ports while a frame plays.
+// It mustn't touch RS, E or the bus though, and RW has to stay LOW
+template <PinName REGISTER_SELECT, PinName ENABLE, PinName DB0, PinName DB1, PinName DB2, PinName DB3, PinName DB4, PinName DB5, PinName DB6, PinName DB7>
+struct STM32_Waveform_Pins {
+    static_assert(STM_PORT(REGISTER_SELECT) <= 2 && STM_PORT(ENABLE) <= 2, "only GPIO ports A to C are on the Arduino header");
+    static_assert(STM_PORT(DB0) <= 2 && STM_PORT(DB1) <= 2 && STM_PORT(DB2) <= 2 && STM_PORT(DB3) <= 2 && STM_PORT(DB4) <= 2 && STM_PORT(DB5) <= 2 && STM_PORT(DB6) <= 2 && STM_PORT(DB7) <= 2,
+        "only GPIO ports A to C are on the Arduino header");
+
+    constexpr static uint8_t PORT_COUNT = 3;
+    constexpr static Port_Pin RS = {STM_PORT(REGISTER_SELECT), STM_PIN(REGISTER_SELECT)};
+    constexpr static Port_Pin E = {STM_PORT(ENABLE), STM_PIN(ENABLE)};
+    constexpr static Port_Pin DATA[8] = {
+        {STM_PORT(DB0), STM_PIN(DB0)}, {STM_PORT(DB1), STM_PIN(DB1)}, {STM_PORT(DB2), STM_PIN(DB2)}, {STM_PORT(DB3), STM_PIN(DB3)},
+        {STM_PORT(DB4), STM_PIN(DB4)}, {STM_PORT(DB5), STM_PIN(DB5)}, {STM_PORT(DB6), STM_PIN(DB6)}, {STM_PORT(DB7), STM_PIN(DB7)},
+    };
+};
+
+template <typename Waveform>
+class STM32_Waveform_Player {
+    public:
+        static_assert(Waveform::PORT_COUNT == 3, "one DMA stream for each of GPIO ports A to C");
+
+        // Once, after the display has been initialised by the driver
+        static void begin(void) {
+            RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+            RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
+
+            // TIM1 runs off APB2, at the full core clock on an F401 with the usual clock setup
+            uint32_t ticks_per_step = (Waveform::STEP_NS * (SystemCoreClock / 1000000) + 999) / 1000;
+            TIM1->CR1 = 0;
+            TIM1->PSC = 0;
+            TIM1->ARR = ticks_per_step - 1;
+            TIM1->CCR1 = 1;
+            TIM1->CCR2 = 1;
+            TIM1->CCR3 = 1;
+            TIM1->DIER = TIM_DIER_CC1DE | TIM_DIER_CC2DE | TIM_DIER_CC3DE;
+        }
+
+        // Starts a frame going and returns straight away. The waveform has to stay where it is until playing() is false,
+        // it can be in flash if it was worked out at compile time
+        static void play(const Waveform &waveform) {
+            while (playing()) {
+                // still sending the last frame
+            }
+
+            TIM1->CNT = 0;
+            start_stream(DMA2_Stream1, &GPIOA->BSRR, waveform.words(0), waveform.length());
+            start_stream(DMA2_Stream2, &GPIOB->BSRR, waveform.words(1), waveform.length());
+            start_stream(DMA2_Stream6, &GPIOC->BSRR, waveform.words(2), waveform.length());
+            TIM1->CR1 |= TIM_CR1_CEN;
+        }
+
+        // A stream turns itself off after its last transfer. The display is still busy with the last byte for up to
+        // STEP_NS * STEPS_PER_WRITE after this goes false, so wait that long before the driver writes to it again
+        static bool playing(void) {
+            if ((DMA2_Stream1->CR | DMA2_Stream2->CR | DMA2_Stream6->CR) & DMA_SxCR_EN) {
+                return true;
+            }
+            TIM1->CR1 &= ~TIM_CR1_CEN;
+            return false;
+        }
+
+    private:
+        static void start_stream(DMA_Stream_TypeDef *stream, volatile uint32_t *bsrr, const uint32_t *words, uint16_t length) {
+            // A stream won't start again while any of its flags from the last frame are still set
+            if (stream == DMA2_Stream1) DMA2->LIFCR = DMA_LIFCR_CFEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CTEIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTCIF1;
+            else if (stream == DMA2_Stream2) DMA2->LIFCR = DMA_LIFCR_CFEIF2 | DMA_LIFCR_CDMEIF2 | DMA_LIFCR_CTEIF2 | DMA_LIFCR_CHTIF2 | DMA_LIFCR_CTCIF2;
+            else DMA2->HIFCR = DMA_HIFCR_CFEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTCIF6;
+
+            stream->PAR = (uint32_t)bsrr;
+            stream->M0AR = (uint32_t)words;
+            stream->NDTR = length;
+            stream->FCR = 0;                            // direct mode, every request moves one word straight away
+            stream->CR = (6UL << DMA_SxCR_CHSEL_Pos)    // channel 6, TIM1
+                | DMA_SxCR_PL_1                         // high priority, a late word stretches the step it belongs to
+                | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1   // 32 bits at both ends
+                | DMA_SxCR_MINC                         // next word each time, always the same BSRR
+                | DMA_SxCR_DIR_0                        // memory to peripheral
+                | DMA_SxCR_EN;
+        }
+};